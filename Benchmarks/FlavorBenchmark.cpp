@@ -0,0 +1,172 @@
+/*
+ * Flavor processing benchmark
+ * Times every flavor x Carbonated loop, per Quality mode, three ways:
+ *  - compiled:    one FlavorRegistry runner call per host block, as
+ *                 FlavorProcessor runs it
+ *  - re-entered:  the same engine, but the block is sliced into control
+ *                 blocks here and the runner is looked up (flavor and
+ *                 Carbonated read from volatiles) and called once per
+ *                 slice. This measures only lookup, call and slicing
+ *                 overhead on identical DSP, not the former switch-based
+ *                 FlavorProcessor::process: that one's shared-state layout
+ *                 and DSP have since changed, so it isn't reproduced here.
+ *  - unfused:     compiled, with the fused saturate + filter kernels off (the
+ *                 stage-by-stage reference path)
+ * Build with -DCARBONATOR_BUILD_BENCHMARKS=ON and run CarbonatorBenchmark.
+ * Figures are nanoseconds per sample frame (all channels), best of kRepeats.
+ */
+
+#include <juce_dsp/juce_dsp.h>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include "DSP/Flavors/FlavorRegistry.h"
+
+namespace
+{
+    constexpr double kSampleRate = 48000.0;
+    constexpr int kNumChannels = 2;
+    constexpr int kBlockSize = 512;
+    constexpr size_t kControlBlockSize = 32;
+    constexpr int kNumBlocks = 1000;     // ~10 s of audio per run
+    constexpr int kRepeats = 5;
+
+    enum class Method
+    {
+        Compiled,
+        Reentered,
+        Unfused
+    };
+
+    struct Result
+    {
+        double nanosecondsPerSample = 0.0;
+        float checksum = 0.0f;           // Keeps the work observable
+    };
+
+    Result run (int flavor, bool carbonated, QualityMode quality, Method method,
+                const juce::AudioBuffer<float>& input)
+    {
+        const juce::dsp::ProcessSpec spec { kSampleRate, static_cast<juce::uint32> (kBlockSize),
+                                            static_cast<juce::uint32> (kNumChannels) };
+        const auto& descriptors = FlavorRegistry::getDescriptors();
+
+        ScratchArena scratch;
+        scratch.prepare (FlavorEngine::getScratchBytes (spec));
+
+        auto engine = descriptors[static_cast<size_t> (flavor)].create();
+        engine->setScratchArena (scratch);
+        engine->setQualityMode (quality);
+        engine->setFusedKernels (method != Method::Unfused);
+        engine->prepare (spec);
+
+        juce::SmoothedValue<float> fizz;
+        fizz.reset (kSampleRate, 0.02);
+        fizz.setCurrentAndTargetValue (0.5f);
+
+        // Read through volatiles, as parameters are: nothing can be hoisted
+        const volatile int selectedFlavor = flavor;
+        const volatile bool selectedCarbonated = carbonated;
+
+        juce::AudioBuffer<float> work (kNumChannels, kBlockSize);
+        Result result;
+        result.nanosecondsPerSample = std::numeric_limits<double>::max();
+
+        for (int repeat = 0; repeat < kRepeats; ++repeat)
+        {
+            engine->reset();
+            const auto start = std::chrono::steady_clock::now();
+
+            for (int b = 0; b < kNumBlocks; ++b)
+            {
+                for (int ch = 0; ch < kNumChannels; ++ch)
+                    work.copyFrom (ch, 0, input, ch, 0, kBlockSize);
+
+                // Fizz sweeps, so every control block redesigns its stages
+                fizz.setTargetValue ((b & 1) != 0 ? 0.3f : 0.7f);
+
+                juce::dsp::AudioBlock<float> block (work);
+                const ScratchArena::Scope scope (scratch);
+
+                if (method == Method::Reentered)
+                {
+                    for (size_t offset = 0; offset < block.getNumSamples(); offset += kControlBlockSize)
+                    {
+                        auto subBlock = block.getSubBlock (offset, juce::jmin (kControlBlockSize, block.getNumSamples() - offset));
+                        const auto& descriptor = descriptors[static_cast<size_t> (selectedFlavor)];
+                        descriptor.process[selectedCarbonated ? 1 : 0] (*engine, subBlock, fizz, kControlBlockSize);
+                    }
+                }
+                else
+                {
+                    descriptors[static_cast<size_t> (selectedFlavor)].process[selectedCarbonated ? 1 : 0] (*engine, block, fizz, kControlBlockSize);
+                }
+
+                result.checksum += work.getSample (0, kBlockSize - 1);
+            }
+
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            result.nanosecondsPerSample = juce::jmin (result.nanosecondsPerSample,
+                                                      elapsed.count() / (static_cast<double> (kNumBlocks) * kBlockSize));
+        }
+
+        return result;
+    }
+}
+
+int main()
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    // Pink-ish noise at about -12 dBFS, the same for every run
+    juce::AudioBuffer<float> input (kNumChannels, kBlockSize);
+    std::mt19937 random (1234);
+    std::uniform_real_distribution<float> white (-0.25f, 0.25f);
+    for (int ch = 0; ch < kNumChannels; ++ch)
+    {
+        float state = 0.0f;
+        for (int i = 0; i < kBlockSize; ++i)
+        {
+            state = 0.9f * state + white (random);
+            input.setSample (ch, i, state);
+        }
+    }
+
+    const std::pair<QualityMode, const char*> qualities[] = {
+        { QualityMode::Standard,    "Standard" },
+        { QualityMode::ADAA,        "ADAA" },
+        { QualityMode::HighQuality, "HQ 4x" }
+    };
+
+    std::printf ("%-13s %-5s %-9s %10s %11s %9s %10s\n",
+                 "Flavor", "Mode", "Quality", "compiled", "re-entered", "overhead", "unfused");
+
+    float checksum = 0.0f;
+
+    for (const auto& [quality, qualityName] : qualities)
+    {
+        for (int flavor = 0; flavor < FlavorRegistry::kNumFlavors; ++flavor)
+        {
+            for (const bool carbonated : { true, false })
+            {
+                const auto compiled = run (flavor, carbonated, quality, Method::Compiled, input);
+                const auto reentered = run (flavor, carbonated, quality, Method::Reentered, input);
+                const auto unfused   = run (flavor, carbonated, quality, Method::Unfused, input);
+                checksum += compiled.checksum + reentered.checksum + unfused.checksum;
+
+                // overhead: re-entered / compiled
+                std::printf ("%-13s %-5s %-9s %10.2f %11.2f %8.2fx %10.2f\n",
+                             FlavorRegistry::getDescriptors()[static_cast<size_t> (flavor)].name,
+                             carbonated ? "CARB" : "FLAT", qualityName,
+                             compiled.nanosecondsPerSample, reentered.nanosecondsPerSample,
+                             reentered.nanosecondsPerSample / compiled.nanosecondsPerSample,
+                             unfused.nanosecondsPerSample);
+            }
+        }
+    }
+
+    std::printf ("(ns per sample frame, %d channels at %.0f Hz, %d-sample blocks; checksum %g)\n",
+                 kNumChannels, kSampleRate, kBlockSize, static_cast<double> (checksum));
+    return 0;
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cmath>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/**
+ * In-place RBJ biquad designs for Carbonator
+ * Same formulas as juce::dsp::IIR::Coefficients::make*(), but written straight
+ * into existing coefficient storage instead of allocating a new Coefficients
+ * object — safe to call on the audio thread.
+ * Output layout matches juce::dsp::IIR::Coefficients: { b0, b1, b2, a1, a2 } / a0.
+ */
+namespace BiquadDesign
+{
+    static constexpr int numCoefficients = 5;
+
+    /** Normalises by a0 and stores the five coefficients. */
+    inline void store (float* c, double b0, double b1, double b2,
+                       double a0, double a1, double a2) noexcept
+    {
+        const double a0Inv = 1.0 / a0;
+        c[0] = static_cast<float> (b0 * a0Inv);
+        c[1] = static_cast<float> (b1 * a0Inv);
+        c[2] = static_cast<float> (b2 * a0Inv);
+        c[3] = static_cast<float> (a1 * a0Inv);
+        c[4] = static_cast<float> (a2 * a0Inv);
+    }
+
+    /** 2nd-order low-pass (bilinear, prewarped) */
+    inline void lowPass (float* c, double sampleRate, double frequency, double q) noexcept
+    {
+        const double n = 1.0 / std::tan (juce::MathConstants<double>::pi * frequency / sampleRate);
+        const double nSquared = n * n;
+        const double invQ = 1.0 / q;
+        const double c1 = 1.0 / (1.0 + invQ * n + nSquared);
+
+        store (c, c1, c1 * 2.0, c1,
+               1.0, c1 * 2.0 * (1.0 - nSquared), c1 * (1.0 - invQ * n + nSquared));
+    }
+
+    /** 2nd-order high-pass (bilinear, prewarped) */
+    inline void highPass (float* c, double sampleRate, double frequency, double q) noexcept
+    {
+        const double n = std::tan (juce::MathConstants<double>::pi * frequency / sampleRate);
+        const double nSquared = n * n;
+        const double invQ = 1.0 / q;
+        const double c1 = 1.0 / (1.0 + invQ * n + nSquared);
+
+        store (c, c1, c1 * -2.0, c1,
+               1.0, c1 * 2.0 * (nSquared - 1.0), c1 * (1.0 - invQ * n + nSquared));
+    }
+
+    /** Peak/bell — gain is a linear factor */
+    inline void peak (float* c, double sampleRate, double frequency, double q, double gain) noexcept
+    {
+        const double A = juce::jmax (0.0, std::sqrt (gain));
+        const double omega = (juce::MathConstants<double>::twoPi * juce::jmax (frequency, 2.0)) / sampleRate;
+        const double alpha = std::sin (omega) / (q * 2.0);
+        const double c2 = -2.0 * std::cos (omega);
+        const double alphaTimesA = alpha * A;
+        const double alphaOverA = alpha / A;
+
+        store (c, 1.0 + alphaTimesA, c2, 1.0 - alphaTimesA,
+               1.0 + alphaOverA, c2, 1.0 - alphaOverA);
+    }
+
+    /** Low shelf — gain is a linear factor */
+    inline void lowShelf (float* c, double sampleRate, double frequency, double q, double gain) noexcept
+    {
+        const double A = juce::jmax (0.0, std::sqrt (gain));
+        const double aminus1 = A - 1.0;
+        const double aplus1 = A + 1.0;
+        const double omega = (juce::MathConstants<double>::twoPi * juce::jmax (frequency, 2.0)) / sampleRate;
+        const double coso = std::cos (omega);
+        const double beta = std::sin (omega) * std::sqrt (A) / q;
+        const double aminus1TimesCoso = aminus1 * coso;
+
+        store (c, A * (aplus1 - aminus1TimesCoso + beta),
+                  A * 2.0 * (aminus1 - aplus1 * coso),
+                  A * (aplus1 - aminus1TimesCoso - beta),
+                  aplus1 + aminus1TimesCoso + beta,
+                  -2.0 * (aminus1 + aplus1 * coso),
+                  aplus1 + aminus1TimesCoso - beta);
+    }
+
+    /** High shelf — gain is a linear factor */
+    inline void highShelf (float* c, double sampleRate, double frequency, double q, double gain) noexcept
+    {
+        const double A = juce::jmax (0.0, std::sqrt (gain));
+        const double aminus1 = A - 1.0;
+        const double aplus1 = A + 1.0;
+        const double omega = (juce::MathConstants<double>::twoPi * juce::jmax (frequency, 2.0)) / sampleRate;
+        const double coso = std::cos (omega);
+        const double beta = std::sin (omega) * std::sqrt (A) / q;
+        const double aminus1TimesCoso = aminus1 * coso;
+
+        store (c, A * (aplus1 + aminus1TimesCoso + beta),
+                  A * -2.0 * (aminus1 + aplus1 * coso),
+                  A * (aplus1 + aminus1TimesCoso - beta),
+                  aplus1 - aminus1TimesCoso + beta,
+                  2.0 * (aminus1 - aplus1 * coso),
+                  aplus1 - aminus1TimesCoso - beta);
+    }
+
+    /** ITU-R BS.1770 K-weighting, first stage: the head's high shelf
+     *  (about +4 dB above 1.5 kHz), re-derived for any sample rate */
+    inline void kWeightingShelf (float* c, double sampleRate) noexcept
+    {
+        constexpr double frequency = 1681.974450955533;
+        constexpr double q = 0.7071752369554196;
+        const double K = std::tan (juce::MathConstants<double>::pi * frequency / sampleRate);
+        const double Vh = std::pow (10.0, 3.999843853973347 / 20.0);
+        const double Vb = std::pow (Vh, 0.4996667741545416);
+
+        store (c, Vh + Vb * K / q + K * K, 2.0 * (K * K - Vh), Vh - Vb * K / q + K * K,
+               1.0 + K / q + K * K, 2.0 * (K * K - 1.0), 1.0 - K / q + K * K);
+    }
+
+    /** ITU-R BS.1770 K-weighting, second stage: the RLB high-pass (38 Hz) */
+    inline void kWeightingHighPass (float* c, double sampleRate) noexcept
+    {
+        constexpr double frequency = 38.13547087602444;
+        constexpr double q = 0.5003270373238773;
+        const double K = std::tan (juce::MathConstants<double>::pi * frequency / sampleRate);
+        const double a0 = 1.0 + K / q + K * K;
+
+        // The standard leaves the numerator unnormalised: { 1, -2, 1 }
+        store (c, a0, -2.0 * a0, a0,
+               a0, 2.0 * (K * K - 1.0), 1.0 - K / q + K * K);
+    }
+
+    enum class Type
+    {
+        LowPass,
+        HighPass,
+        Peak,
+        LowShelf,
+        HighShelf
+    };
+
+    /** Designs a response into c[numCoefficients]. gainDb is ignored by
+     *  the LowPass/HighPass types. */
+    inline void design (Type type, double sampleRate, float frequency, float q,
+                        float gainDb, float* c) noexcept
+    {
+        const double gain = juce::Decibels::decibelsToGain (static_cast<double> (gainDb));
+
+        switch (type)
+        {
+            case Type::LowPass:   lowPass (c, sampleRate, frequency, q); break;
+            case Type::HighPass:  highPass (c, sampleRate, frequency, q); break;
+            case Type::Peak:      peak (c, sampleRate, frequency, q, gain); break;
+            case Type::LowShelf:  lowShelf (c, sampleRate, frequency, q, gain); break;
+            case Type::HighShelf: highShelf (c, sampleRate, frequency, q, gain); break;
+        }
+    }
+}
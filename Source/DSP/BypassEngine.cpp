@@ -0,0 +1,77 @@
+#include "BypassEngine.h"
+#include <cmath>
+
+void BypassEngine::prepare (const juce::dsp::ProcessSpec& spec, float maxLatencySamples)
+{
+    dryDelay.prepare (static_cast<int> (spec.numChannels), maxLatencySamples);
+    fadeSamples = juce::jmax (1, juce::roundToInt (spec.sampleRate * kCrossfadeSeconds));
+
+    // Equal-power gains, computed once: the wet gain at dry share k is
+    // fadeGains[k], the dry gain fadeGains[fadeSamples - k]
+    fadeGains.resize (static_cast<size_t> (fadeSamples) + 1);
+    for (int k = 0; k <= fadeSamples; ++k)
+        fadeGains[static_cast<size_t> (k)] = static_cast<float> (std::cos (juce::MathConstants<double>::halfPi * k / fadeSamples));
+
+    reset();
+}
+
+void BypassEngine::reset() noexcept
+{
+    dryDelay.reset();
+    fadeRemaining = 0;
+    fadingFromSilence = false;
+}
+
+void BypassEngine::fadeInFromSilence() noexcept
+{
+    reset();
+
+    if (! bypassed)
+    {
+        fadeRemaining = fadeSamples;
+        fadingFromSilence = true;
+    }
+}
+
+bool BypassEngine::setBypassed (bool shouldBeBypassed) noexcept
+{
+    if (shouldBeBypassed == bypassed)
+        return false;
+
+    const bool wetWasIdle = isWetPathIdle();
+    bypassed = shouldBeBypassed;
+    fadingFromSilence = false;
+
+    // Reversing mid-fade picks up from the current mix instead of jumping
+    fadeRemaining = fadeSamples - fadeRemaining;
+    return wetWasIdle;
+}
+
+void BypassEngine::crossfade (juce::dsp::AudioBlock<float>& block, const juce::dsp::AudioBlock<float>& dry) noexcept
+{
+    const auto nChannels = block.getNumChannels();
+    const auto nSamples = block.getNumSamples();
+
+    for (size_t i = 0; i < nSamples; ++i)
+    {
+        // Dry share in samples: 0 = fully wet, fadeSamples = fully dry
+        int position = bypassed ? fadeSamples : 0;
+        if (fadeRemaining > 0)
+        {
+            --fadeRemaining;
+            position = bypassed ? fadeSamples - fadeRemaining : fadeRemaining;
+        }
+
+        const float wetGain = fadeGains[static_cast<size_t> (position)];
+        const float dryGain = fadingFromSilence ? 0.0f : fadeGains[static_cast<size_t> (fadeSamples - position)];
+
+        for (size_t ch = 0; ch < nChannels; ++ch)
+        {
+            auto* data = block.getChannelPointer (ch);
+            data[i] = wetGain * data[i] + dryGain * dry.getChannelPointer (ch)[i];
+        }
+    }
+
+    if (fadeRemaining == 0)
+        fadingFromSilence = false;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "LatencyCompensator.h"
+#include "ScratchArena.h"
+
+/**
+ * Click-free, latency-compensated bypass for Carbonator
+ * The dry path goes through a LatencyCompensator set to the wet path's
+ * latency, fraction included, so engaging bypass doesn't shift the signal in
+ * time and the crossfade doesn't comb.
+ * Engaging or releasing it runs a short equal-power crossfade between the
+ * wet path and the delayed dry path. Once settled:
+ *   - bypassed: only the dry delay runs, the wet path isn't called at all
+ *   - active:   the wet path runs and the dry line is just kept current
+ */
+class BypassEngine
+{
+public:
+    static constexpr double kCrossfadeSeconds = 0.01;
+
+    BypassEngine() = default;
+
+    /** maxLatencySamples: the longest latency setDryDelay() will be given */
+    void prepare (const juce::dsp::ProcessSpec& spec, float maxLatencySamples);
+    void reset() noexcept;
+
+    /** Scratch process() takes while crossfading, for blocks of up to spec.maximumBlockSize */
+    static size_t getScratchBytes (const juce::dsp::ProcessSpec& spec) noexcept
+    {
+        return ScratchArena::getBlockBytes (spec.numChannels, spec.maximumBlockSize);
+    }
+
+    /** Starts a crossfade towards the new state. Returns true when the wet
+     *  path is about to be resumed after not running at all — the caller
+     *  should bring its stale state up to date. A release that reverses a
+     *  fade still running returns false: the wet path never stopped. */
+    bool setBypassed (bool shouldBeBypassed) noexcept;
+
+    bool isBypassed() const noexcept { return bypassed; }
+
+    /** Bypassed and settled: process() won't call the wet path */
+    bool isWetPathIdle() const noexcept { return bypassed && fadeRemaining == 0; }
+
+    /** For a wet path restarting from cleared state (e.g. after the chain
+     *  slept through silence): clears the dry line and, unless bypassed,
+     *  fades the wet path in from silence over the crossfade time */
+    void fadeInFromSilence() noexcept;
+
+    /** Delay of the dry path: the wet path's latency, fractional delays included,
+     *  so the two stay phase-aligned through a crossfade */
+    void setDryDelay (float latencySamples) noexcept { dryDelay.setDelay (latencySamples); }
+
+    /** Heap held by the dry delay line and the fade gains */
+    size_t getMemoryBytes() const noexcept { return dryDelay.getMemoryBytes() + fadeGains.size() * sizeof (float); }
+
+    /** Runs processWet (AudioBlock<float>&) on the block as needed and leaves
+     *  the wet, dry or crossfaded signal in it */
+    template <typename ProcessWet>
+    void process (juce::dsp::AudioBlock<float>& block, ScratchArena& scratch, ProcessWet&& processWet)
+    {
+        if (fadeRemaining == 0)
+        {
+            if (bypassed)
+            {
+                dryDelay.process (block);
+            }
+            else
+            {
+                dryDelay.push (block);
+                processWet (block);
+            }
+            return;
+        }
+
+        const ScratchArena::Scope scope (scratch);
+        auto dry = scratch.allocateBlock (block.getNumChannels(), block.getNumSamples());
+        dry.copyFrom (block);
+        dryDelay.process (dry);
+
+        processWet (block);
+        crossfade (block, dry);
+    }
+
+private:
+    /** Equal-power mix of block (wet) and dry, advancing the fade */
+    void crossfade (juce::dsp::AudioBlock<float>& block, const juce::dsp::AudioBlock<float>& dry) noexcept;
+
+    LatencyCompensator dryDelay;
+    std::vector<float> fadeGains;     // cos (k / fadeSamples * pi / 2), k = 0..fadeSamples
+    int fadeSamples = 1;
+    int fadeRemaining = 0;
+    bool fadingFromSilence = false;   // The running fade's dry side is silence
+    bool bypassed = false;
+};
@@ -3,35 +3,98 @@
 
 EffectsChain::EffectsChain (juce::AudioProcessorValueTreeState& apvts)
     : apvts (apvts),
-      flavorProcessor (apvts)
+      flavorProcessor (apvts, scratchArena),
+      oversampledFlavorProcessor (apvts, scratchArena)
 {
     using namespace ParameterIDs;
 
     bypassParam = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter (Global::bypass.getParamID()));
     fizzAmountParam = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter (Filter::fizzAmount.getParamID()));
     carbonatedParam = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter (Filter::carbonated.getParamID()));
-    qualityModeParam = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter (Global::qualityMode.getParamID()));
+    qualityModeParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter (Global::qualityMode.getParamID()));
+    oversamplingParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter (Global::oversampling.getParamID()));
+    oversamplingFilterParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter (Global::oversamplingFilter.getParamID()));
+    constantLatencyParam = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter (Global::constantLatency.getParamID()));
 }
 
 void EffectsChain::prepare (const juce::dsp::ProcessSpec& spec)
 {
+    // The render profile only ever changes here, never mid-render
+    renderOffline = nonRealtimeRequested;
+
     // Output gain control
-    outputGain.prepare (spec);
-    outputGain.setRampDurationSeconds (0.05);
+    outputGain.reset (spec.sampleRate, 0.05);
+    outputGain.setCurrentAndTargetValue (getOutputGainTarget());
 
     // Safety limiter
     outputLimiter.prepare (spec);
     outputLimiter.setThreshold (0.0f);
     outputLimiter.setRelease (50.0f);
 
-    // Flavor processor
+    // Scratch for whichever flavor processor is running, sized once for the
+    // announced block size; larger host blocks are processed in chunks
+    const auto chainFactor = 1u << chainOversamplingStages;
+    auto oversampledSpec = spec;
+    oversampledSpec.sampleRate = spec.sampleRate * chainFactor;
+    oversampledSpec.maximumBlockSize = spec.maximumBlockSize * chainFactor;
+
+    sampleRate = spec.sampleRate;
+    maxBlockSize = static_cast<size_t> (spec.maximumBlockSize);
+    numChannels = static_cast<size_t> (spec.numChannels);
+    scratchArena.prepare (BypassEngine::getScratchBytes (spec)
+                          + juce::jmax (FlavorProcessor::getScratchBytes (spec),
+                                        FlavorProcessor::getScratchBytes (oversampledSpec)));
+
+    // Flavor processor: the selected flavor(s) only; offline, the render
+    // waits for any other flavor when it's switched to
+    flavorProcessor.setNonRealtime (renderOffline);
     flavorProcessor.prepare (spec);
 
+    // HQ Chain: every flavor stage prepared at the oversampled rate, with the
+    // control rate scaled so Fizz updates keep the same spacing in time
+    for (size_t filter = 0; filter < chainOversamplers.size(); ++filter)
+    {
+        auto& os = chainOversamplers[filter];
+        os = std::make_unique<juce::dsp::Oversampling<float>> (
+            spec.numChannels, static_cast<size_t> (chainOversamplingStages),
+            static_cast<SaturationEngine::OversamplingFilter> (filter) == SaturationEngine::OversamplingFilter::LinearPhaseFIR
+                ? juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple
+                : juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR);
+        os->initProcessing (spec.maximumBlockSize);
+    }
+
+    // Its engines (4x rate, 4x block size) are only built once HQ Chain is
+    // first selected — offline too, so a render that never uses it never
+    // builds them
+    oversampledFlavorProcessor.setNonRealtime (renderOffline);
+    oversampledFlavorProcessor.prepareDeferred (oversampledSpec);
+    oversampledFlavorProcessor.setControlBlockSize (FlavorProcessor::kDefaultControlBlockSize * static_cast<int> (chainFactor));
+
+    // Constant Latency: the slowest path is either 16x FIR saturation or the
+    // HQ Chain pair (its inner saturation runs without oversampling). The
+    // extra half sample keeps every padding delay in the compensator's
+    // fractional range, so the IIR half-bands' fractional latency is aligned too.
+    float maxLatency = SaturationEngine::getMaxLatencyInSamples();
+    for (const auto& os : chainOversamplers)
+        maxLatency = juce::jmax (maxLatency, os->getLatencyInSamples());
+
+    constantLatency = std::ceil (maxLatency + 0.5f);
+    latencyCompensator.prepare (static_cast<int> (spec.numChannels), constantLatency);
+    bypassEngine.prepare (spec, constantLatency);
+
+    loadMeasurer.reset (spec.sampleRate, static_cast<int> (spec.maximumBlockSize));
+
+    processChainOversampled = false;
+    updateQualitySettings();  // So getLatencyInSamples() is right before the first block
+
     // Auto-gain compensation (50ms ramp)
     autoGainCompensation.reset (spec.sampleRate, 0.05);
     autoGainCompensation.setCurrentAndTargetValue (1.0f);
-    inputRMS = 0.0f;
-    outputRMS = 0.0f;
+    inputLoudness.prepare (spec);
+    outputLoudness.prepare (spec);
+
+    silentSamples = 0;
+    outputSilent = false;
 
 #ifdef CARBONATOR_DEMO
     playDurationSamples = static_cast<int> (spec.sampleRate * 60.0);
@@ -44,35 +107,106 @@ void EffectsChain::prepare (const juce::dsp::ProcessSpec& spec)
 
 void EffectsChain::process (juce::dsp::ProcessContextReplacing<float>& context)
 {
-    // Global bypass
-    if (bypassParam->get())
-        return;
+    if (maxBlockSize == 0)
+        return;   // Not prepared yet
+
+    const ScratchArena::AudioThreadScope audioThread;
 
     auto& block = context.getOutputBlock();
-    const auto nChannels = block.getNumChannels();
     const auto nSamples = block.getNumSamples();
 
-    // 1. Measure input RMS (per-channel average, exponential smoothing)
+    juce::AudioProcessLoadMeasurer::ScopedTimer loadTimer (loadMeasurer, static_cast<int> (nSamples));
+
+    // Kept current while bypassed, so the dry path matches the reported latency
+    updateQualitySettings();
+
+    // Global bypass: the wet path fades back in already settled on the
+    // input it missed (see recordWetInput())
+    if (bypassEngine.setBypassed (bypassParam->get() || context.isBypassed))
+        restartWetPath();
+
+    bypassEngine.setDryDelay (getLatencyInSamples());   // The wet path's, fraction included
+
+    // Idle instance: once the input has stayed silent for longer than the
+    // tail and the latency, the output has decayed too and nothing needs to run
+    if (isSilent (block))
     {
-        float sumSq = 0.0f;
-        for (size_t ch = 0; ch < nChannels; ++ch)
+        const double silenceTimeout = getTailLengthSeconds() * sampleRate + std::ceil (getLatencyInSamples());
+        const bool tailDecayed = static_cast<double> (silentSamples) >= silenceTimeout;
+        silentSamples += static_cast<juce::int64> (nSamples);
+
+        if (tailDecayed)
         {
-            const auto* data = block.getChannelPointer (ch);
-            for (size_t i = 0; i < nSamples; ++i)
-                sumSq += data[i] * data[i];
+            block.clear();
+            outputSilent = true;
+            return;
         }
-        float blockRMS = std::sqrt (sumSq / static_cast<float> (nChannels * nSamples + 1));
-        inputRMS += rmsAlpha * (blockRMS - inputRMS);
     }
+    else
+    {
+        silentSamples = 0;
+    }
+
+    if (outputSilent)
+    {
+        // Waking up: whatever the stages remember has long decayed, and with
+        // the shapers' bias offset removed cleared state is what silence
+        // leaves behind. The wet path still fades in rather than starting
+        // at full gain.
+        outputSilent = false;
+        resetWetPath();
+        bypassEngine.fadeInFromSilence();
+    }
+
+    // Hosts may send more than the announced maximumBlockSize: no stage is
+    // ever asked for more than it was prepared for
+    for (size_t offset = 0; offset < nSamples; offset += maxBlockSize)
+    {
+        auto chunk = block.getSubBlock (offset, juce::jmin (maxBlockSize, nSamples - offset));
+
+        if (bypassEngine.isWetPathIdle())
+            recordWetInput (chunk);
+
+        bypassEngine.process (chunk, scratchArena, [this] (juce::dsp::AudioBlock<float>& wet)
+        {
+            juce::dsp::ProcessContextReplacing<float> chunkContext (wet);
+            processChunk (chunkContext);
+        });
+    }
+}
+
+void EffectsChain::processChunk (juce::dsp::ProcessContextReplacing<float>& context)
+{
+    auto& block = context.getOutputBlock();
+    const auto nChannels = block.getNumChannels();
+    const auto nSamples = block.getNumSamples();
 
-    // 2. Pass Fizz amount (0-1), Carbonated state, and quality mode to FlavorProcessor
+    // 1. Measure input loudness
+    inputLoudness.process (block);
+
+    // 2. Pass Fizz amount (0-1) and Carbonated state to FlavorProcessor
     float fizzNormalized = fizzAmountParam->get() / 100.0f;
     flavorProcessor.setFizzAmount (fizzNormalized);
     flavorProcessor.setCarbonated (carbonatedParam->get());
-    flavorProcessor.setQualityMode (qualityModeParam->get());
+    oversampledFlavorProcessor.setFizzAmount (fizzNormalized);
+    oversampledFlavorProcessor.setCarbonated (carbonatedParam->get());
+
+    // 3. Process through flavor DSP — HQ Chain runs the whole flavor in one up/down pair
+    if (processChainOversampled)
+    {
+        auto oversampledBlock = chainOversampling->processSamplesUp (block);
+        juce::dsp::ProcessContextReplacing<float> oversampledContext (oversampledBlock);
+        oversampledFlavorProcessor.process (oversampledContext);
+        chainOversampling->processSamplesDown (block);
+    }
+    else
+    {
+        flavorProcessor.process (context);
+    }
 
-    // 3. Process through flavor DSP
-    flavorProcessor.process (context);
+    // Pad up to the constant latency (no-op when it's off)
+    latencyCompensator.setDelay (isLatencyConstant() ? constantLatency - getProcessingLatency() : 0.0f);
+    latencyCompensator.process (block);
 
 #ifndef CARBONATOR_DEMO
     // License check #2 (anti-patch scatter) — clears audio if unlicensed
@@ -84,44 +218,25 @@ void EffectsChain::process (juce::dsp::ProcessContextReplacing<float>& context)
     }
 #endif
 
-    // 4. Measure output RMS
-    {
-        float sumSq = 0.0f;
-        for (size_t ch = 0; ch < nChannels; ++ch)
-        {
-            const auto* data = block.getChannelPointer (ch);
-            for (size_t i = 0; i < nSamples; ++i)
-                sumSq += data[i] * data[i];
-        }
-        float blockRMS = std::sqrt (sumSq / static_cast<float> (nChannels * nSamples + 1));
-        outputRMS += rmsAlpha * (blockRMS - outputRMS);
-    }
-
-    // 5. Compute and apply auto-gain correction (clamped to +/-12dB)
-    if (outputRMS > 1e-6f && inputRMS > 1e-6f)
+    // 4. Auto-gain correction from the loudness measured so far (clamped to
+    //    +/-12dB), held while either side is below the BS.1770 absolute gate
+    const float inputMeanSquare = inputLoudness.getMeanSquare();
+    const float outputMeanSquare = outputLoudness.getMeanSquare();
+    if (inputMeanSquare > LoudnessMeter::kGateMeanSquare && outputMeanSquare > LoudnessMeter::kGateMeanSquare)
     {
-        float correction = inputRMS / outputRMS;
-        // Clamp to +/-12dB range
         constexpr float maxGain = 3.981f;  // +12dB
         constexpr float minGain = 0.251f;  // -12dB
-        correction = juce::jlimit (minGain, maxGain, correction);
-        autoGainCompensation.setTargetValue (correction);
+        autoGainCompensation.setTargetValue (juce::jlimit (minGain, maxGain, std::sqrt (inputMeanSquare / outputMeanSquare)));
     }
 
-    // Apply smoothed auto-gain
-    for (size_t i = 0; i < nSamples; ++i)
+    // 5. Measure output loudness, then auto-gain and user output gain, in one pass
+    outputGain.setTargetValue (getOutputGainTarget());
+    outputLoudness.processAndApplyGain (block, [this]
     {
-        float gain = autoGainCompensation.getNextValue();
-        for (size_t ch = 0; ch < nChannels; ++ch)
-            block.getChannelPointer (ch)[i] *= gain;
-    }
-
-    // 6. User output gain + safety limiter
-    using namespace ParameterIDs;
-    float outGainDb = apvts.getRawParameterValue (Global::outputGain.getParamID())->load();
-    outputGain.setGainDecibels (outGainDb);
+        return autoGainCompensation.getNextValue() * outputGain.getNextValue();
+    });
 
-    outputGain.process (context);
+    // 6. Safety limiter
     outputLimiter.process (context);
 
 #ifdef CARBONATOR_DEMO
@@ -175,12 +290,10 @@ void EffectsChain::process (juce::dsp::ProcessContextReplacing<float>& context)
 
 void EffectsChain::reset()
 {
-    outputGain.reset();
-    outputLimiter.reset();
-    flavorProcessor.reset();
-    autoGainCompensation.setCurrentAndTargetValue (1.0f);
-    inputRMS = 0.0f;
-    outputRMS = 0.0f;
+    resetWetPath();
+    bypassEngine.reset();
+    silentSamples = 0;
+    outputSilent = false;
 
 #ifdef CARBONATOR_DEMO
     sampleCounter = 0;
@@ -189,12 +302,183 @@ void EffectsChain::reset()
 #endif
 }
 
+void EffectsChain::resetWetPath()
+{
+    resetWetPathStages();
+    flavorProcessor.reset();
+    oversampledFlavorProcessor.reset();
+}
+
+void EffectsChain::restartWetPath()
+{
+    resetWetPathStages();
+
+    auto& running = processChainOversampled ? oversampledFlavorProcessor : flavorProcessor;
+    auto& stopped = processChainOversampled ? flavorProcessor : oversampledFlavorProcessor;
+    stopped.reset();
+
+    // The engines are pre-rolled with the settings they are about to run with
+    running.setFizzAmount (fizzAmountParam->get() / 100.0f);
+    running.setCarbonated (carbonatedParam->get());
+    running.restart();
+}
+
+void EffectsChain::resetWetPathStages()
+{
+    outputGain.setCurrentAndTargetValue (outputGain.getTargetValue());
+    outputLimiter.reset();
+    for (auto& os : chainOversamplers)
+        if (os != nullptr)
+            os->reset();
+    latencyCompensator.reset();
+    autoGainCompensation.setCurrentAndTargetValue (1.0f);
+    inputLoudness.reset();
+    outputLoudness.reset();
+}
+
+void EffectsChain::recordWetInput (const juce::dsp::AudioBlock<float>& block)
+{
+    // A memory copy at the base rate; HQ Chain also runs the chain's
+    // upsampler, whose state restartWetPath() clears again
+    if (! processChainOversampled)
+        flavorProcessor.recordInput (block);
+    else if (chainOversampling != nullptr)
+        oversampledFlavorProcessor.recordInput (chainOversampling->processSamplesUp (block));
+}
+
+float EffectsChain::getOutputGainTarget() const
+{
+    using namespace ParameterIDs;
+    return juce::Decibels::decibelsToGain (apvts.getRawParameterValue (Global::outputGain.getParamID())->load());
+}
+
+double EffectsChain::getTailLengthSeconds() const
+{
+    return flavorProcessor.getTailLengthSeconds (carbonatedParam->get());
+}
+
+bool EffectsChain::isSilent (const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+    {
+        const auto range = juce::FloatVectorOperations::findMinAndMax (block.getChannelPointer (ch),
+                                                                       static_cast<int> (block.getNumSamples()));
+        if (range.getStart() < -kSilenceThreshold || range.getEnd() > kSilenceThreshold)
+            return false;
+    }
+
+    return true;
+}
+
 float EffectsChain::getLatencyInSamples() const
 {
-    return flavorProcessor.getLatencyInSamples();
+    if (isLatencyConstant())
+        return constantLatency;
+
+    return getProcessingLatency();
+}
+
+bool EffectsChain::isLatencyConstant() const
+{
+    return renderOffline || constantLatencyParam->get();
+}
+
+float EffectsChain::getProcessingLatency() const
+{
+    // From the parameter, so a Carbonated switch moves the latency on the
+    // block it happens in
+    const bool carbonated = carbonatedParam->get();
+
+    if (processChainOversampled && chainOversampling != nullptr)
+        return chainOversampling->getLatencyInSamples() + oversampledFlavorProcessor.getLatencyInSamples (carbonated);
+
+    return flavorProcessor.getLatencyInSamples (carbonated);
+}
+
+MemoryReport EffectsChain::getMemoryReport() const
+{
+    MemoryReport report;
+
+    report.add ("Chain", "scratch arena", scratchArena.getCapacity());
+
+    size_t chainOversamplingBytes = 0;
+    for (size_t filter = 0; filter < chainOversamplers.size(); ++filter)
+        if (chainOversamplers[filter] != nullptr)
+            chainOversamplingBytes += SaturationEngine::getOversamplingBytes (chainOversamplingStages,
+                                                                              static_cast<SaturationEngine::OversamplingFilter> (filter),
+                                                                              numChannels, maxBlockSize);
+    report.add ("Chain", "HQ Chain oversampling", chainOversamplingBytes);
+    report.add ("Chain", "latency compensator", latencyCompensator.getMemoryBytes());
+    report.add ("Chain", "bypass dry delay", bypassEngine.getMemoryBytes());
+
+    flavorProcessor.reportMemory (report, {});
+    oversampledFlavorProcessor.reportMemory (report, "HQ Chain / ");
+    return report;
+}
+
+void EffectsChain::updateQualitySettings()
+{
+    using OversamplingFilter = SaturationEngine::OversamplingFilter;
+
+    const auto mode = static_cast<QualityMode> (qualityModeParam->getIndex());
+    const int oversamplingStages = oversamplingParam->getIndex() + 1;
+    auto filter = static_cast<OversamplingFilter> (oversamplingFilterParam->getIndex());
+
+    if (renderOffline)
+    {
+        // HQ Chain already oversamples everything and is kept; every other
+        // mode bounces with oversampled saturation
+        filter = OversamplingFilter::LinearPhaseFIR;
+        flavorProcessor.setQualityMode (QualityMode::HighQuality);
+        flavorProcessor.setOversampling (juce::jmax (oversamplingStages, offlineMinOversamplingStages), filter);
+    }
+    else
+    {
+        flavorProcessor.setQualityMode (mode);
+        flavorProcessor.setOversampling (oversamplingStages, filter);
+    }
+
+    flavorProcessor.setExactNonlinearities (renderOffline);
+    oversampledFlavorProcessor.setQualityMode (QualityMode::OversampledChain);
+    oversampledFlavorProcessor.setExactNonlinearities (renderOffline);
+
+    setChainOversampling (mode == QualityMode::OversampledChain, filter);
+}
+
+void EffectsChain::setChainOversampling (bool enabled, SaturationEngine::OversamplingFilter filter)
+{
+    auto* os = chainOversamplers[static_cast<size_t> (filter)].get();
+    if (os == nullptr)
+        return;   // Not prepared yet
+
+    // First use of HQ Chain: its engine is built in the background while the
+    // base-rate path keeps playing
+    if (enabled && ! oversampledFlavorProcessor.activate())
+        enabled = false;
+
+    // The path being switched to last ran who knows when: start it from silence
+    if (enabled && (! processChainOversampled || os != chainOversampling))
+    {
+        os->reset();
+        if (! processChainOversampled)
+            oversampledFlavorProcessor.reset();
+    }
+    else if (! enabled && processChainOversampled)
+    {
+        flavorProcessor.reset();
+    }
+
+    chainOversampling = os;
+    processChainOversampled = enabled;
+}
+
+void EffectsChain::setQualityMode (QualityMode mode)
+{
+    flavorProcessor.setQualityMode (mode);
 }
 
-void EffectsChain::setQualityMode (bool hq)
+void EffectsChain::setNoiseSeed (std::uint64_t seed) noexcept
 {
-    flavorProcessor.setQualityMode (hq);
+    flavorProcessor.setNoiseSeed (seed);
+    oversampledFlavorProcessor.setNoiseSeed (seed);
 }
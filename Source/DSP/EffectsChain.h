@@ -3,11 +3,25 @@
 #include <juce_dsp/juce_dsp.h>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "FlavorProcessor.h"
+#include "ScratchArena.h"
+#include "LatencyCompensator.h"
+#include "BypassEngine.h"
+#include "LoudnessMeter.h"
 
 /**
  * Main effects chain for Carbonator v2.0
  * Signal flow: Input -> FlavorProcessor (Fizz morphing + Carbonated toggle)
  *              -> Auto-Gain Compensation -> Output Gain -> Safety Limiter
+ * In the HQ Chain quality mode the FlavorProcessor stage is swapped for a
+ * second instance prepared at 4x the host rate, wrapped in one up/down pair.
+ * With Constant Latency on, a fractional delay after the flavor stage pads
+ * every quality setting up to the slowest one's latency.
+ * Bypass (the parameter, or context.isBypassed from the host) crossfades to
+ * a dry path delayed by the wet path's exact latency; see BypassEngine.
+ * Auto-gain matches the K-weighted (BS.1770) loudness of the output to the
+ * input's and is applied in the same pass as the output gain.
+ * Once the input has been silent for longer than the flavor's tail, nothing
+ * runs at all until it comes back.
  */
 class EffectsChain
 {
@@ -15,14 +29,51 @@ public:
     explicit EffectsChain (juce::AudioProcessorValueTreeState& apvts);
 
     void prepare (const juce::dsp::ProcessSpec& spec);
+    /** Bypassed when the bypass parameter or context.isBypassed is set */
     void process (juce::dsp::ProcessContextReplacing<float>& context);
     void reset();
 
-    /** Get total processing latency (oversampling) */
+    /** Latency to report to the host: the current quality setting's
+     *  oversampling latency, or with Constant Latency on (and in offline
+     *  renders) the fixed, whole-sample worst case (see
+     *  getConstantLatencyInSamples()) */
     float getLatencyInSamples() const;
 
-    /** Set quality mode (oversampling on/off) */
-    void setQualityMode (bool hq);
+    /** Worst-case latency over every quality setting (including the offline
+     *  profile), rounded up to whole samples with at least half a sample of
+     *  padding to spare. Known once prepare() has run. */
+    float getConstantLatencyInSamples() const { return constantLatency; }
+
+    /** Tail of the selected flavor(s) in the current Carbonated state;
+     *  infinite for flavors that generate sound of their own (any thread) */
+    double getTailLengthSeconds() const;
+
+    /** True when the last process() call was skipped as silent: its output
+     *  is all zeros. Lets the caller flag the host buffer as cleared. */
+    bool isOutputSilent() const noexcept { return outputSilent; }
+
+    /** Heap held by this instance, per flavor engine and per buffer. Engines
+     *  not prepared (flavors never selected, or released) hold nothing. */
+    MemoryReport getMemoryReport() const;
+
+    /** Fraction of the real-time budget used by process() (0-1, smoothed).
+     *  Lets the quality modes' CPU cost be compared in any host. */
+    double getProcessingLoad() const { return loadMeasurer.getLoadAsProportion(); }
+
+    /** Set quality mode (Standard / HQ / ADAA) */
+    void setQualityMode (QualityMode mode);
+
+    /** Offline render profile: while the host bounces, saturation runs at
+     *  least 8x linear-phase FIR oversampled with exact tanh (HQ Chain keeps
+     *  its 4x whole-chain path, with FIR filters), regardless of the other
+     *  Quality parameters. Latched by the next prepare(), and the render is
+     *  padded to the constant latency (as with Constant Latency on), so the
+     *  latency stays fixed for the whole render whatever Quality does. */
+    void setNonRealtime (bool isNonRealtime) { nonRealtimeRequested = isNonRealtime; }
+
+    /** Per-instance seed of the flavors' noise sources (any thread). Part of
+     *  the plugin state, so a session renders the same noise every time. */
+    void setNoiseSeed (std::uint64_t seed) noexcept;
 
 #ifndef CARBONATOR_DEMO
     /** Set pointer to license activated flag (audio-thread safe read) */
@@ -32,26 +83,98 @@ public:
 private:
     juce::AudioProcessorValueTreeState& apvts;
 
-    // Output gain control
-    juce::dsp::Gain<float> outputGain;
+    // Output gain control (linear gain, 50ms ramp)
+    juce::SmoothedValue<float> outputGain;
 
     // Safety limiter (prevents clipping)
     juce::dsp::Limiter<float> outputLimiter;
 
+    // Temporary buffers of both flavor processors (only one runs per block)
+    ScratchArena scratchArena;
+    size_t maxBlockSize = 0;                 // Announced by the host in prepare()
+    size_t numChannels = 0;
+
     // Flavor effect processor (handles all DSP + Fizz morphing + Carbonated toggle)
     FlavorProcessor flavorProcessor;
 
-    // Auto-gain compensation (smoothed)
+    // HQ Chain: the same flavors prepared at chainOversamplingFactor x the host
+    // rate — lazily, the first time HQ Chain is selected
+    static constexpr int chainOversamplingStages = 2;   // 4x
+    FlavorProcessor oversampledFlavorProcessor;
+    std::array<std::unique_ptr<juce::dsp::Oversampling<float>>, 2> chainOversamplers;  // [OversamplingFilter]
+    juce::dsp::Oversampling<float>* chainOversampling = nullptr;
+    bool processChainOversampled = false;
+
+    // Constant Latency: pads the current path up to constantLatency
+    LatencyCompensator latencyCompensator;
+    float constantLatency = 0.0f;
+
+    // Delay-matched dry path and the wet/dry crossfade
+    BypassEngine bypassEngine;
+
+    juce::AudioProcessLoadMeasurer loadMeasurer;
+
+    // Silence detection: input below kSilenceThreshold for longer than the
+    // tail plus latency puts the instance to sleep
+    static constexpr float kSilenceThreshold = 1.0e-6f;   // -120 dBFS, FlavorEngine::kTailDecayDb
+    double sampleRate = 44100.0;
+    juce::int64 silentSamples = 0;
+    bool outputSilent = false;
+
+    // Auto-gain compensation: K-weighted loudness before and after the
+    // flavor stage, integrated per sample (independent of the block size)
+    LoudnessMeter inputLoudness;
+    LoudnessMeter outputLoudness;
     juce::SmoothedValue<float> autoGainCompensation;
-    float inputRMS = 0.0f;
-    float outputRMS = 0.0f;
-    static constexpr float rmsAlpha = 0.01f;  // Exponential smoothing coefficient
+
+    // Offline render profile, latched in prepare()
+    bool nonRealtimeRequested = false;
+    bool renderOffline = false;
+    static constexpr int offlineMinOversamplingStages = 3;  // 8x
+
+    /** The whole chain for a block of at most maxBlockSize samples */
+    void processChunk (juce::dsp::ProcessContextReplacing<float>& context);
+
+    /** Every sample of every channel below kSilenceThreshold */
+    static bool isSilent (const juce::dsp::AudioBlock<float>& block) noexcept;
+
+    /** Output Gain parameter as a linear gain */
+    float getOutputGainTarget() const;
+
+    /** Clears everything the wet path remembers, so it restarts from silence */
+    void resetWetPath();
+
+    /** Un-bypass: as resetWetPath(), but the running flavor processor is
+     *  pre-rolled on the input recorded while bypassed (recordWetInput()) */
+    void restartWetPath();
+
+    /** Output stages, compensators and meters of resetWetPath() */
+    void resetWetPathStages();
+
+    /** Bypassed: the input the running flavor processor would have seen goes
+     *  to its pre-roll history instead */
+    void recordWetInput (const juce::dsp::AudioBlock<float>& block);
+
+    /** Constant Latency on, or an offline render */
+    bool isLatencyConstant() const;
+
+    /** Latency of the flavor path currently running (fractional) */
+    float getProcessingLatency() const;
+
+    /** Push the Quality parameters (or the offline profile) to the flavor processors */
+    void updateQualitySettings();
+
+    /** Select the flavor path: base rate, or whole chain inside one up/down pair */
+    void setChainOversampling (bool enabled, SaturationEngine::OversamplingFilter filter);
 
     // Parameter pointers
     juce::AudioParameterBool* bypassParam;
     juce::AudioParameterFloat* fizzAmountParam;
     juce::AudioParameterBool* carbonatedParam;
-    juce::AudioParameterBool* qualityModeParam;
+    juce::AudioParameterChoice* qualityModeParam;
+    juce::AudioParameterChoice* oversamplingParam;
+    juce::AudioParameterChoice* oversamplingFilterParam;
+    juce::AudioParameterBool* constantLatencyParam;
 
 #ifndef CARBONATOR_DEMO
     const std::atomic<bool>* licenseFlag = nullptr;
@@ -0,0 +1,163 @@
+#include "FilterCascade.h"
+#include <cmath>
+#include <utility>
+
+void FilterCascade::prepare (const juce::dsp::ProcessSpec& spec, int newNumStages, ScratchArena& scratchToUse)
+{
+    ScratchArena::assertNotOnAudioThread();
+    jassert (newNumStages >= 1 && newNumStages <= kMaxStages);
+    jassert (spec.numChannels <= static_cast<juce::uint32> (kMaxChannels));
+
+    sampleRate = spec.sampleRate;
+    numStages = juce::jlimit (1, kMaxStages, newNumStages);
+    numChannels = juce::jlimit (1, kMaxChannels, static_cast<int> (spec.numChannels));
+    numVecs = (numChannels + kLanes - 1) / kLanes;
+
+    stages.fill ({});
+
+    scratch = &scratchToUse;
+
+    reset();
+}
+
+void FilterCascade::reset() noexcept
+{
+    for (int s = 0; s < kMaxStages; ++s)
+    {
+        state1[static_cast<size_t> (s)].fill (Vec::expand (0.0f));
+        state2[static_cast<size_t> (s)].fill (Vec::expand (0.0f));
+    }
+}
+
+void FilterCascade::copyChannelState (size_t source, size_t dest) noexcept
+{
+    jassert (source < static_cast<size_t> (numChannels) && dest < static_cast<size_t> (numChannels));
+    const auto lanes = static_cast<size_t> (kLanes);
+
+    for (auto* state : { &state1, &state2 })
+    {
+        for (int s = 0; s < numStages; ++s)
+        {
+            auto& vecs = (*state)[static_cast<size_t> (s)];
+            vecs[dest / lanes].set (dest % lanes, vecs[source / lanes].get (source % lanes));
+        }
+    }
+}
+
+void FilterCascade::setBiquad (int stage, const float* coefficients) noexcept
+{
+    jassert (stage >= 0 && stage < numStages);
+    auto& st = stages[static_cast<size_t> (stage)];
+
+    st.kind = Kind::Biquad;
+    for (int i = 0; i < BiquadDesign::numCoefficients; ++i)
+        st.c[i] = coefficients[i];
+}
+
+void FilterCascade::setSVF (int stage, SVFType type, float cutoff, float resonance) noexcept
+{
+    jassert (stage >= 0 && stage < numStages);
+    auto& st = stages[static_cast<size_t> (stage)];
+
+    if (st.kind == Kind::SVF && st.type == type && st.cutoff == cutoff && st.resonance == resonance)
+        return;
+
+    // Same design as juce::dsp::StateVariableTPTFilter::update()
+    const double g = std::tan (juce::MathConstants<double>::pi * cutoff / sampleRate);
+    const double R2 = 1.0 / resonance;
+
+    st.kind = Kind::SVF;
+    st.type = type;
+    st.cutoff = cutoff;
+    st.resonance = resonance;
+    st.c[0] = static_cast<float> (g);
+    st.c[1] = static_cast<float> (g + R2);
+    st.c[2] = static_cast<float> (1.0 / (1.0 + R2 * g + g * g));
+    st.c[3] = type == SVFType::LowPass  ? 1.0f : 0.0f;
+    st.c[4] = type == SVFType::BandPass ? 1.0f : 0.0f;
+    st.c[5] = type == SVFType::HighPass ? 1.0f : 0.0f;
+}
+
+// ─── Compiled cascade layouts ───
+
+template <int stageCount, unsigned svfMask>
+void FilterCascade::runStages (float* interleaved, size_t nSamples, size_t frameSize) noexcept
+{
+    Vec c[stageCount][kNumCoefficients];
+    for (int s = 0; s < stageCount; ++s)
+        for (int k = 0; k < kNumCoefficients; ++k)
+            c[s][k] = Vec::expand (stages[static_cast<size_t> (s)].c[k]);
+
+    for (int v = 0; v < numVecs; ++v)
+    {
+        Vec s1[stageCount], s2[stageCount];
+        for (int s = 0; s < stageCount; ++s)
+        {
+            s1[s] = state1[static_cast<size_t> (s)][static_cast<size_t> (v)];
+            s2[s] = state2[static_cast<size_t> (s)][static_cast<size_t> (v)];
+        }
+
+        auto* frame = interleaved + v * kLanes;
+
+        for (size_t i = 0; i < nSamples; ++i, frame += frameSize)
+        {
+            Vec x = Vec::fromRawArray (frame);
+
+            [&]<size_t... s> (std::index_sequence<s...>)
+            {
+                ((x = tick<((svfMask >> s) & 1u) != 0 ? Kind::SVF : Kind::Biquad> (x, c[s], s1[s], s2[s])), ...);
+            } (std::make_index_sequence<static_cast<size_t> (stageCount)> {});
+
+            x.copyToRawArray (frame);
+        }
+
+        for (int s = 0; s < stageCount; ++s)
+        {
+            state1[static_cast<size_t> (s)][static_cast<size_t> (v)] = s1[s];
+            state2[static_cast<size_t> (s)][static_cast<size_t> (v)] = s2[s];
+        }
+    }
+}
+
+namespace
+{
+    /** Layouts are numbered by stage count, then SVF mask:
+     *  index = 2^stageCount - 2 + svfMask, 2 + 4 + 8 + 16 in all */
+    constexpr int getLayoutIndex (int stageCount, unsigned svfMask) noexcept
+    {
+        return (1 << stageCount) - 2 + static_cast<int> (svfMask);
+    }
+
+    constexpr int getLayoutStageCount (size_t index) noexcept
+    {
+        int stageCount = 1;
+        while (static_cast<int> (index) >= getLayoutIndex (stageCount + 1, 0))
+            ++stageCount;
+        return stageCount;
+    }
+
+    constexpr unsigned getLayoutMask (size_t index) noexcept
+    {
+        return static_cast<unsigned> (static_cast<int> (index) - getLayoutIndex (getLayoutStageCount (index), 0));
+    }
+}
+
+void FilterCascade::runCascade (float* interleaved, size_t nSamples, size_t frameSize) noexcept
+{
+    using Runner = void (FilterCascade::*) (float*, size_t, size_t) noexcept;
+    static constexpr int kNumLayouts = getLayoutIndex (kMaxStages + 1, 0);
+
+    static constexpr auto runners = []<size_t... index> (std::index_sequence<index...>)
+    {
+        return std::array<Runner, sizeof... (index)> {
+            &FilterCascade::runStages<getLayoutStageCount (index), getLayoutMask (index)>...
+        };
+    } (std::make_index_sequence<static_cast<size_t> (kNumLayouts)> {});
+
+    unsigned svfMask = 0;
+    for (int s = 0; s < numStages; ++s)
+        if (stages[static_cast<size_t> (s)].kind == Kind::SVF)
+            svfMask |= 1u << s;
+
+    (this->*runners[static_cast<size_t> (getLayoutIndex (numStages, svfMask))]) (interleaved, nSamples, frameSize);
+}
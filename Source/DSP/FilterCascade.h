@@ -0,0 +1,195 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "BiquadDesign.h"
+#include "ScratchArena.h"
+
+/**
+ * Channel-packed filter cascade for Carbonator
+ * Up to kMaxStages second-order sections — TDF-II biquads and TPT
+ * state-variable filters, freely mixed — run in a single pass over the block.
+ * The channels are interleaved into juce::dsp::SIMDRegister lanes, so every
+ * arithmetic step advances all channels (stereo fits one register) and each
+ * sample is loaded and stored once for the whole cascade instead of once per
+ * stage. SVF stages match juce::dsp::StateVariableTPTFilter exactly, including
+ * its behaviour under cutoff modulation.
+ * The stage layout (count, and Biquad or SVF per stage) is resolved once per
+ * block to a loop compiled for it, so the per-sample path never branches on it.
+ * A per-sample operation (e.g. a waveshaper) can be fused in front of the
+ * sections, so a whole "shape -> filter -> filter..." flavor runs in one loop.
+ * The interleave frames live in the owner's ScratchArena for the duration of
+ * process() only.
+ */
+class FilterCascade
+{
+public:
+    static constexpr int kMaxStages = 4;
+    static constexpr int kMaxChannels = 8;
+
+    enum class SVFType
+    {
+        LowPass,
+        BandPass,
+        HighPass
+    };
+
+    FilterCascade() = default;
+
+    /** Every stage starts as a pass-through biquad. process() takes its
+     *  interleave frames from scratch (see getScratchBytes()). */
+    void prepare (const juce::dsp::ProcessSpec& spec, int numStages, ScratchArena& scratch);
+    void reset() noexcept;
+
+    /** Channel dest's filter memory becomes a copy of channel source's — for a
+     *  channel resuming after it sat out carrying the same signal */
+    void copyChannelState (size_t source, size_t dest) noexcept;
+
+    /** Scratch one process() call needs for blocks of up to spec.maximumBlockSize */
+    static size_t getScratchBytes (const juce::dsp::ProcessSpec& spec) noexcept
+    {
+        return ScratchArena::getSliceBytes (static_cast<size_t> (spec.maximumBlockSize) * getFrameSize (static_cast<int> (spec.numChannels)));
+    }
+
+    void process (juce::dsp::AudioBlock<float>& block) noexcept
+    {
+        process (block, [] (float x) noexcept { return x; });
+    }
+
+    /** Fused pass: preStage (float -> float, stateless, same for every channel)
+     *  is applied as the block is interleaved, so it costs no pass of its own
+     *  and vectorises along each channel. */
+    template <typename PreStage>
+    void process (juce::dsp::AudioBlock<float>& block, PreStage&& preStage) noexcept;
+
+    /** Biquad stage from precomputed { b0, b1, b2, a1, a2 } (BiquadDesign layout,
+     *  e.g. a FizzMorphTable row). */
+    void setBiquad (int stage, const float* coefficients) noexcept;
+
+    /** TPT state-variable stage. The tan() prewarp is only recomputed when the
+     *  type, cutoff or resonance actually change. */
+    void setSVF (int stage, SVFType type, float cutoff,
+                 float resonance = 1.0f / juce::MathConstants<float>::sqrt2) noexcept;
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int kLanes = static_cast<int> (Vec::SIMDNumElements);
+    static constexpr int kMaxVecs = (kMaxChannels + kLanes - 1) / kLanes;
+
+    /** Floats per interleaved sample: the channels rounded up to whole registers */
+    static size_t getFrameSize (int channels) noexcept
+    {
+        return static_cast<size_t> ((juce::jlimit (1, kMaxChannels, channels) + kLanes - 1) / kLanes * kLanes);
+    }
+
+    enum class Kind
+    {
+        Biquad,
+        SVF
+    };
+
+    /** Biquad: b0 b1 b2 a1 a2 / SVF: g, g + R2, h, then the LP, BP, HP output weights */
+    static constexpr int kNumCoefficients = 6;
+
+    struct Stage
+    {
+        Kind kind = Kind::Biquad;
+        float c[kNumCoefficients] = { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+        // Last SVF design inputs
+        SVFType type = SVFType::LowPass;
+        float cutoff = 0.0f;
+        float resonance = 0.0f;
+    };
+
+    template <Kind kind>
+    static Vec tick (Vec x, const Vec* c, Vec& s1, Vec& s2) noexcept
+    {
+        if constexpr (kind == Kind::Biquad)
+        {
+            // Transposed direct form II
+            const Vec y = c[0] * x + s1;
+            s1 = c[1] * x - c[3] * y + s2;
+            s2 = c[2] * x - c[4] * y;
+            return y;
+        }
+        else
+        {
+            // Zavalishin TPT SVF, c = { g, g + R2, h, wLP, wBP, wHP }
+            const Vec hp = c[2] * (x - c[1] * s1 - s2);
+            const Vec bp = c[0] * hp + s1;
+            s1 = c[0] * hp + bp;
+            const Vec lp = c[0] * bp + s2;
+            s2 = c[0] * bp + lp;
+
+            // One weight is 1 and the others 0, so the output is exactly the
+            // selected response and one loop serves all three types
+            return c[3] * lp + c[4] * bp + c[5] * hp;
+        }
+    }
+
+    /** Step 2 of process(): the whole cascade over the interleaved frames.
+     *  Dispatches once per block to the runStages() instantiation for the
+     *  current stage count and Biquad/SVF layout. */
+    void runCascade (float* interleaved, size_t nSamples, size_t frameSize) noexcept;
+
+    /** The cascade with its layout fixed at compile time: bit s of svfMask
+     *  set means stage s is an SVF, so the per-sample loop has no branches */
+    template <int stageCount, unsigned svfMask>
+    void runStages (float* interleaved, size_t nSamples, size_t frameSize) noexcept;
+
+    std::array<Stage, kMaxStages> stages;
+    int numStages = 1;
+    int numChannels = 2;
+    int numVecs = 1;
+    double sampleRate = 44100.0;
+
+    // State [stage][vec], channels packed into lanes
+    std::array<std::array<Vec, kMaxVecs>, kMaxStages> state1 {}, state2 {};
+
+    ScratchArena* scratch = nullptr;
+};
+
+template <typename PreStage>
+void FilterCascade::process (juce::dsp::AudioBlock<float>& block, PreStage&& preStage) noexcept
+{
+    const auto nChannels = juce::jmin (block.getNumChannels(), static_cast<size_t> (numChannels));
+    const auto nSamples = block.getNumSamples();
+    const auto frameSize = static_cast<size_t> (numVecs * kLanes);
+
+    // Interleaved frames: numVecs * kLanes floats per sample, cache-line aligned
+    jassert (scratch != nullptr);
+    const ScratchArena::Scope scope (*scratch);
+    float* interleaved = scratch->allocate (nSamples * frameSize);
+
+    // 1. Interleave (through the pre-stage): one frame of lanes per sample.
+    //    Spare lanes are kept at zero.
+    for (size_t ch = 0; ch < frameSize; ++ch)
+    {
+        auto* dst = interleaved + ch;
+
+        if (ch < nChannels)
+        {
+            const auto* src = block.getChannelPointer (ch);
+            for (size_t i = 0; i < nSamples; ++i)
+                dst[i * frameSize] = preStage (src[i]);
+        }
+        else
+        {
+            for (size_t i = 0; i < nSamples; ++i)
+                dst[i * frameSize] = 0.0f;
+        }
+    }
+
+    // 2. Whole cascade per frame — state lives in registers for the block
+    runCascade (interleaved, nSamples, frameSize);
+
+    // 3. De-interleave back into the block
+    for (size_t ch = 0; ch < nChannels; ++ch)
+    {
+        const auto* src = interleaved + ch;
+        auto* dst = block.getChannelPointer (ch);
+
+        for (size_t i = 0; i < nSamples; ++i)
+            dst[i] = src[i * frameSize];
+    }
+}
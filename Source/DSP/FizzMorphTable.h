@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include <juce_core/juce_core.h>
+
+/**
+ * Precomputed Fizz morph table for one flavor's parameter map.
+ * ControlSet is a plain struct of floats (drives, thresholds, biquad
+ * coefficients...). The map is sampled at numPoints evenly spaced Fizz values
+ * when the table is built in prepare(); lookups are a linear interpolation
+ * between the two neighbouring rows — no pow/exp/trig on the audio thread.
+ */
+template <typename ControlSet>
+class FizzMorphTable
+{
+public:
+    static_assert (std::is_trivially_copyable_v<ControlSet>, "ControlSet must be a plain struct of floats");
+    static_assert (sizeof (ControlSet) % sizeof (float) == 0, "ControlSet must be a plain struct of floats");
+
+    static constexpr int numValues = static_cast<int> (sizeof (ControlSet) / sizeof (float));
+    static constexpr int numIntervals = 256;
+    static constexpr int numPoints = numIntervals + 1;
+
+    /** Samples mapFizz (float fizz -> ControlSet) across 0-1. Allocates: call from prepare(). */
+    template <typename MapFunction>
+    void build (MapFunction&& mapFizz)
+    {
+        rows.resize (static_cast<size_t> (numPoints * numValues));
+
+        for (int i = 0; i < numPoints; ++i)
+        {
+            const ControlSet set = mapFizz (static_cast<float> (i) / static_cast<float> (numIntervals));
+            std::memcpy (rows.data() + i * numValues, &set, sizeof (ControlSet));
+        }
+    }
+
+    /** Interpolated control set for a Fizz value (0-1). */
+    ControlSet lookup (float fizz) const noexcept
+    {
+        jassert (! rows.empty());
+
+        const float position = juce::jlimit (0.0f, 1.0f, fizz) * static_cast<float> (numIntervals);
+        const int index = juce::jmin (static_cast<int> (position), numIntervals - 1);
+        const float frac = position - static_cast<float> (index);
+
+        const float* a = rows.data() + index * numValues;
+        const float* b = a + numValues;
+
+        float values[numValues];
+        for (int v = 0; v < numValues; ++v)
+            values[v] = a[v] + frac * (b[v] - a[v]);
+
+        ControlSet set;
+        std::memcpy (&set, values, sizeof (ControlSet));
+        return set;
+    }
+
+    size_t getMemoryBytes() const noexcept { return rows.size() * sizeof (float); }
+
+private:
+    std::vector<float> rows;
+};
@@ -1,16 +1,84 @@
 #include "FlavorProcessor.h"
-#include "FizzCurves.h"
-#include <cmath>
+#include <cstring>
 
-// Max delay buffer size for modulated delays (200ms at 192kHz)
-static constexpr int kMaxDelayBufferSize = 38400;
-// Chorus delay buffer (50ms)
-static constexpr int kChorusBufferSize = 9600;
+// =============================================================================
+// Background preparation — one thread shared by every plugin instance
+// =============================================================================
+class FlavorProcessor::PreparationThread : private juce::Thread
+{
+public:
+    PreparationThread() : juce::Thread ("Carbonator flavor preparation")
+    {
+        startThread (juce::Thread::Priority::background);
+    }
+
+    ~PreparationThread() override
+    {
+        stopThread (2000);
+    }
+
+    void add (FlavorProcessor& processor)
+    {
+        const juce::ScopedLock sl (lock);
+        processors.addIfNotAlreadyThere (&processor);
+    }
+
+    /** Blocks while the processor's flavors are being prepared */
+    void remove (FlavorProcessor& processor)
+    {
+        const juce::ScopedLock sl (lock);
+        processors.removeFirstMatchingValue (&processor);
+    }
+
+    /** Wakes the thread and blocks until it has finished a pass over the
+     *  processors (or the poll interval has gone by) — offline renders only */
+    void waitForPass()
+    {
+        notify();
+        passFinished.wait (kPollIntervalMs);
+    }
+
+private:
+    // Polled rather than signalled, so the audio thread only ever flips an atomic
+    static constexpr int kPollIntervalMs = 10;
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            {
+                const juce::ScopedLock sl (lock);
+                for (auto* processor : processors)
+                    processor->prepareRequestedFlavors();
+            }
+
+            passFinished.signal();
+
+            wait (kPollIntervalMs);
+        }
+    }
+
+    juce::CriticalSection lock;
+    juce::Array<FlavorProcessor*> processors;
+    juce::WaitableEvent passFinished;
+};
+
+// =============================================================================
+FlavorProcessor::FlavorProcessor (juce::AudioProcessorValueTreeState& apvts, ScratchArena& scratchToUse)
+    : scratch (scratchToUse)
+{
+    namespace IDs = ParameterIDs::Flavor;
+    flavorTypeParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter (IDs::type.getParamID()));
+    blendParam = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter (IDs::blend.getParamID()));
+    blendFlavorParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter (IDs::blendFlavor.getParamID()));
+    blendMorphParam = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter (IDs::blendMorph.getParamID()));
+
+    preparationThread->add (*this);
+}
 
-FlavorProcessor::FlavorProcessor (juce::AudioProcessorValueTreeState& apvts)
+FlavorProcessor::~FlavorProcessor()
 {
-    using namespace ParameterIDs::Flavor;
-    flavorTypeParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter (type.getParamID()));
+    preparationThread->remove (*this);
 }
 
 void FlavorProcessor::setFizzAmount (float newFizz)
@@ -23,669 +91,695 @@ void FlavorProcessor::setCarbonated (bool isCarbonated)
     carbonatedState = isCarbonated;
 }
 
-void FlavorProcessor::setQualityMode (bool hq)
+// Settings are stored and pushed to the running engines; an engine picks
+// them up when it starts running (see applySettings())
+void FlavorProcessor::setQualityMode (QualityMode mode)
 {
-    saturationEngine.setOversamplingEnabled (hq);
+    qualityMode = mode;
+    forEachRunningEngine ([mode] (FlavorEngine& engine) { engine.setQualityMode (mode); });
 }
 
-float FlavorProcessor::getLatencyInSamples() const
+void FlavorProcessor::setOversampling (int numStages, SaturationEngine::OversamplingFilter filter)
 {
-    return saturationEngine.getLatencyInSamples();
+    oversamplingStages = numStages;
+    oversamplingFilter = filter;
+    forEachRunningEngine ([=] (FlavorEngine& engine) { engine.setOversampling (numStages, filter); });
+
+    // Offline, the new variant runs from this block on
+    if (renderOffline)
+        forEachRunningEngine ([this] (FlavorEngine& engine)
+        {
+            while (! engine.updateOversampler())
+                preparationThread->waitForPass();
+        });
 }
 
-void FlavorProcessor::prepare (const juce::dsp::ProcessSpec& spec)
+void FlavorProcessor::setExactNonlinearities (bool shouldBeExact)
 {
-    sampleRate = spec.sampleRate;
-    numChannels = static_cast<int>(spec.numChannels);
-    blockSize = static_cast<int>(spec.maximumBlockSize);
+    exactNonlinearities = shouldBeExact;
+    forEachRunningEngine ([shouldBeExact] (FlavorEngine& engine) { engine.setExactNonlinearities (shouldBeExact); });
+}
 
-    // SmoothedValue for Fizz (~20ms ramp)
-    smoothedFizz.reset (sampleRate, 0.02);
-    smoothedFizz.setCurrentAndTargetValue (0.5f);
+void FlavorProcessor::setFusedKernels (bool shouldFuse)
+{
+    useFusedKernels = shouldFuse;
+    forEachRunningEngine ([shouldFuse] (FlavorEngine& engine) { engine.setFusedKernels (shouldFuse); });
+}
 
-    // Shared saturation engine
-    saturationEngine.prepare (spec);
-
-    // ─── COLA ───────────────────────────────────────────────────
-    colaCompressor.prepare (spec);
-    colaDCBlocker.prepare (spec);
-    colaDCBlocker.setType (juce::dsp::StateVariableTPTFilterType::highpass);
-    colaDCBlocker.setCutoffFrequency (5.0f);
-    colaLowShelf.prepare (spec);
-    colaHighShelf.prepare (spec);
-
-    // ─── CHERRY ─────────────────────────────────────────────────
-    cherryDeHarsh.prepare (spec);
-    cherryPresence.prepare (spec);
-    cherryAirShelf.prepare (spec);
-    cherryChorusPhase = 0.0f;
-    cherryChorusDelayBuffer.setSize (numChannels, kChorusBufferSize);
-    cherryChorusDelayBuffer.clear();
-    cherryChorusWritePos = 0;
-
-    // ─── GRAPE ──────────────────────────────────────────────────
-    grapeDCBlocker.prepare (spec);
-    grapeDCBlocker.setType (juce::dsp::StateVariableTPTFilterType::highpass);
-    grapeDCBlocker.setCutoffFrequency (5.0f);
-    grapeTapeLP.prepare (spec);
-    grapeTapeLP.setType (juce::dsp::StateVariableTPTFilterType::lowpass);
-    grapeDelayBuffer.setSize (numChannels, kMaxDelayBufferSize);
-    grapeDelayBuffer.clear();
-    grapeDelayWritePos = 0;
-    grapeWowPhase = 0.0f;
-    grapeFlutterPhase = 0.0f;
-    grapeVinylRumbleLP.prepare (spec);
-    grapeVinylRumbleLP.setType (juce::dsp::StateVariableTPTFilterType::lowpass);
-    grapeVinylRumbleLP.setCutoffFrequency (40.0f);
-
-    // ─── LEMON-LIME ─────────────────────────────────────────────
-    lemonLowPass1.prepare (spec);
-    lemonLowPass1.setType (juce::dsp::StateVariableTPTFilterType::lowpass);
-    lemonLowPass2.prepare (spec);
-    lemonLowPass2.setType (juce::dsp::StateVariableTPTFilterType::lowpass);
-    lemonHighPass1.prepare (spec);
-    lemonHighPass1.setType (juce::dsp::StateVariableTPTFilterType::highpass);
-    lemonHighPass2.prepare (spec);
-    lemonHighPass2.setType (juce::dsp::StateVariableTPTFilterType::highpass);
-    lemonLowBandBuffer.setSize (numChannels, blockSize);
-    lemonHFCompressor.prepare (spec);
-    lemonPresence.prepare (spec);
-    lemonAirShelf.prepare (spec);
-    lemonTeleBandpass.prepare (spec);
-    lemonTeleHighCut.prepare (spec);
-
-    // ─── ORANGE CREAM (Lowpass Filter + Drive) ──────────────────
-    orangeLP1.prepare (spec);
-    orangeLP1.setType (juce::dsp::StateVariableTPTFilterType::lowpass);
-    orangeLP2.prepare (spec);
-    orangeLP2.setType (juce::dsp::StateVariableTPTFilterType::lowpass);
-    orangeLowShelf.prepare (spec);
+void FlavorProcessor::applySettings (FlavorEngine& engine) const
+{
+    engine.setQualityMode (qualityMode);
+    engine.setOversampling (oversamplingStages, oversamplingFilter);
+    engine.setExactNonlinearities (exactNonlinearities);
+    engine.setFusedKernels (useFusedKernels);
+    engine.setNoiseSeed (noiseSeed.load (std::memory_order_relaxed));
 }
 
-void FlavorProcessor::process (juce::dsp::ProcessContextReplacing<float>& context)
+float FlavorProcessor::getLatencyInSamples (bool carbonated) const
 {
-    auto& outputBlock = context.getOutputBlock();
-    juce::dsp::AudioBlock<float> block (outputBlock);
+    // Every engine runs with the same quality settings
+    if (activeFlavor < 0)
+        return 0.0f;
 
-    auto flavorType = static_cast<FlavorType>(flavorTypeParam->getIndex());
+    const auto& descriptor = FlavorRegistry::getDescriptors()[static_cast<size_t> (activeFlavor)];
+    return slots[static_cast<size_t> (activeFlavor)].engine->getLatencyInSamples (descriptor.getSaturationStages (carbonated));
+}
+
+double FlavorProcessor::getTailLengthSeconds (bool carbonated) const
+{
+    const auto& descriptors = FlavorRegistry::getDescriptors();
+    double tail = descriptors[static_cast<size_t> (getSelectedFlavorIndex())].getTailLengthSeconds (carbonated);
 
-    if (carbonatedState)
+    if (blendParam->get())
     {
-        switch (flavorType)
-        {
-            case FlavorType::Cola:        processCola (block); break;
-            case FlavorType::Cherry:      processCherry (block); break;
-            case FlavorType::Grape:       processGrape (block); break;
-            case FlavorType::LemonLime:   processLemonLime (block); break;
-            case FlavorType::OrangeCream: processOrangeCream (block); break;
-        }
-    }
-    else
-    {
-        // FLAT (Carbonated OFF) — per-flavor alternate mode
-        switch (flavorType)
-        {
-            case FlavorType::Cola:        processCola (block); processColaFlat (block); break;
-            case FlavorType::Cherry:      processCherry (block); processCherryFlat (block); break;
-            case FlavorType::Grape:       processGrapeFlat (block); break;
-            case FlavorType::LemonLime:   processLemonLime (block); processLemonLimeFlat (block); break;
-            case FlavorType::OrangeCream: processOrangeCreamFlat (block); break;
-        }
+        const auto blend = juce::jlimit (0, kNumFlavors - 1, blendFlavorParam->getIndex());
+        tail = juce::jmax (tail, descriptors[static_cast<size_t> (blend)].getTailLengthSeconds (carbonated));
     }
+
+    return tail;
 }
 
-void FlavorProcessor::reset()
+void FlavorProcessor::reportMemory (MemoryReport& report, const juce::String& ownerPrefix) const
 {
-    saturationEngine.reset();
-
-    colaCompressor.reset();
-    colaDCBlocker.reset();
-    colaLowShelf.reset();
-    colaHighShelf.reset();
-
-    cherryDeHarsh.reset();
-    cherryPresence.reset();
-    cherryAirShelf.reset();
-    cherryChorusDelayBuffer.clear();
-    cherryChorusWritePos = 0;
-    cherryChorusPhase = 0.0f;
-
-    grapeDCBlocker.reset();
-    grapeTapeLP.reset();
-    grapeDelayBuffer.clear();
-    grapeDelayWritePos = 0;
-    grapeWowPhase = 0.0f;
-    grapeFlutterPhase = 0.0f;
-    grapeVinylRumbleLP.reset();
-
-    lemonLowPass1.reset();
-    lemonLowPass2.reset();
-    lemonHighPass1.reset();
-    lemonHighPass2.reset();
-    lemonHFCompressor.reset();
-    lemonPresence.reset();
-    lemonAirShelf.reset();
-    lemonTeleBandpass.reset();
-    lemonTeleHighCut.reset();
-
-    orangeLP1.reset();
-    orangeLP2.reset();
-    orangeLowShelf.reset();
+    // Engines are created and released under this lock
+    const juce::ScopedLock sl (preparationLock);
+    const auto& descriptors = FlavorRegistry::getDescriptors();
+
+    for (int i = 0; i < kNumFlavors; ++i)
+        if (const auto& engine = slots[static_cast<size_t> (i)].engine)
+            engine->reportMemory (report, ownerPrefix + descriptors[static_cast<size_t> (i)].name);
+
+    report.add (ownerPrefix + "Flavor processor", "pre-roll input history",
+                static_cast<size_t> (inputHistory.getNumChannels() * inputHistory.getNumSamples()) * sizeof (float));
 }
 
-// =============================================================================
-// COLA — Analog Console Warmth
-// =============================================================================
-void FlavorProcessor::processCola (juce::dsp::AudioBlock<float>& block)
+void FlavorProcessor::setTransitionTime (double seconds)
 {
-    const auto nSamples = block.getNumSamples();
-    float fizz = smoothedFizz.getCurrentValue();
-
-    // Fizz-morphed parameters (shaped curves)
-    float drive      = FizzCurves::exponential (fizz, 1.0f, 4.0f, 2.5f);
-    float compRatio  = FizzCurves::exponential (fizz, 1.5f, 6.0f, 2.0f);
-    float compThresh = FizzCurves::linear (fizz, -6.0f, -30.0f);
-    float lowGainDb  = FizzCurves::logarithmic (fizz, 0.0f, 3.5f, 1.8f);
-    float highGainDb = FizzCurves::logarithmic (fizz, 0.0f, -3.0f, 1.8f);
-
-    // Advance smoothed fizz for the block
-    for (size_t i = 0; i < nSamples; ++i)
-        smoothedFizz.getNextValue();
-
-    // Oversampled asymmetric soft clip via SaturationEngine
-    SaturationEngine::Params satParams;
-    satParams.curve = SaturationEngine::CurveType::AsymSoftClip;
-    satParams.drive = drive;
-    satParams.dcBias = 0.1f;
-    saturationEngine.process (block, satParams);
-
-    // DC Blocker (HPF @ 5Hz)
-    {
-        juce::dsp::ProcessContextReplacing<float> ctx (block);
-        colaDCBlocker.process (ctx);
-    }
-
-    // Compressor
-    colaCompressor.setRatio (compRatio);
-    colaCompressor.setThreshold (compThresh);
-    colaCompressor.setAttack (10.0f);
-    colaCompressor.setRelease (100.0f);
-    {
-        juce::dsp::ProcessContextReplacing<float> ctx (block);
-        colaCompressor.process (ctx);
-    }
+    transitionSeconds = juce::jmax (0.0, seconds);
+}
 
-    // Tilt EQ: low shelf + high shelf
-    *colaLowShelf.state = *juce::dsp::IIR::Coefficients<float>::makeLowShelf (
-        sampleRate, 200.0f, 0.707f, juce::Decibels::decibelsToGain (lowGainDb));
-    *colaHighShelf.state = *juce::dsp::IIR::Coefficients<float>::makeHighShelf (
-        sampleRate, 8000.0f, 0.707f, juce::Decibels::decibelsToGain (highGainDb));
+void FlavorProcessor::setControlBlockSize (int numSamples)
+{
+    controlBlockSize = static_cast<size_t> (juce::jlimit (8, kMaxControlBlockSize, numSamples));
+}
 
-    {
-        juce::dsp::ProcessContextReplacing<float> ctx (block);
-        colaLowShelf.process (ctx);
-    }
-    {
-        juce::dsp::ProcessContextReplacing<float> ctx (block);
-        colaHighShelf.process (ctx);
-    }
-    // No static makeup gain — auto-gain compensation handles this in EffectsChain
+int FlavorProcessor::getSelectedFlavorIndex() const
+{
+    return juce::jlimit (0, kNumFlavors - 1, flavorTypeParam->getIndex());
 }
 
-void FlavorProcessor::processColaFlat (juce::dsp::AudioBlock<float>& block)
+size_t FlavorProcessor::getScratchBytes (const juce::dsp::ProcessSpec& spec) noexcept
 {
-    // FLAT: extra tape saturation layer
-    // Runs inline (not through SaturationEngine) to avoid double-pumping the
-    // oversampling filters — the signal is already band-limited from processCola's
-    // oversampled saturation pass.
-    const auto nChannels = block.getNumChannels();
-    const auto nSamples = block.getNumSamples();
-    float fizz = smoothedFizz.getCurrentValue();
-    float tapeDrive = FizzCurves::exponential (fizz, 1.0f, 3.0f, 2.0f);
+    const auto numSamples = static_cast<size_t> (spec.maximumBlockSize);
 
-    for (size_t ch = 0; ch < nChannels; ++ch)
-    {
-        auto* data = block.getChannelPointer (ch);
-        for (size_t i = 0; i < nSamples; ++i)
-            data[i] = std::tanh (data[i] * tapeDrive) / tapeDrive;
-    }
+    // Blend output, outgoing (transition) output and the morph ramp, plus
+    // whatever the engine running inside them needs
+    return 2 * ScratchArena::getBlockBytes (spec.numChannels, numSamples)
+         + ScratchArena::getSliceBytes (numSamples)
+         + FlavorEngine::getScratchBytes (spec);
 }
 
-// =============================================================================
-// CHERRY — Sweet Vocal Presence
-// =============================================================================
-void FlavorProcessor::processCherry (juce::dsp::AudioBlock<float>& block)
-{
-    float fizz = smoothedFizz.getCurrentValue();
-
-    // Fizz-morphed parameters (shaped curves)
-    float blend   = FizzCurves::sCurve (fizz, 0.10f, 0.65f);
-    float drive   = FizzCurves::exponential (fizz, 1.5f, 4.5f, 2.5f);
-    float presDb  = FizzCurves::logarithmic (fizz, 0.0f, 6.0f, 1.8f);
-    float airDb   = FizzCurves::logarithmic (fizz, 0.0f, 4.0f, 1.8f);
-    float harshDb = FizzCurves::logarithmic (fizz, 0.0f, -4.0f, 1.8f);
-
-    // Oversampled parallel saturation via SaturationEngine (mix handles parallel blend)
-    SaturationEngine::Params satParams;
-    satParams.curve = SaturationEngine::CurveType::Tanh;
-    satParams.drive = drive;
-    satParams.outputGain = 1.0f / drive;  // Normalize: tanh(x*d)/d
-    satParams.mix = blend;
-    saturationEngine.process (block, satParams);
-
-    // De-harsh notch @ 3.5kHz
-    float harshGain = juce::Decibels::decibelsToGain (harshDb);
-    *cherryDeHarsh.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter (
-        sampleRate, 3500.0f, 2.0f, harshGain);
-    {
-        juce::dsp::ProcessContextReplacing<float> ctx (block);
-        cherryDeHarsh.process (ctx);
-    }
+FlavorEngine& FlavorProcessor::createEngine (int flavor)
+{
+    auto& engine = slots[static_cast<size_t> (flavor)].engine;
 
-    // Presence bell @ 4.5kHz
-    float presGain = juce::Decibels::decibelsToGain (presDb);
-    *cherryPresence.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter (
-        sampleRate, 4500.0f, 1.5f, presGain);
+    if (engine == nullptr)
     {
-        juce::dsp::ProcessContextReplacing<float> ctx (block);
-        cherryPresence.process (ctx);
+        engine = FlavorRegistry::getDescriptors()[static_cast<size_t> (flavor)].create();
+        engine->setScratchArena (scratch);
     }
 
-    // Air shelf @ 12kHz
-    float airGain = juce::Decibels::decibelsToGain (airDb);
-    *cherryAirShelf.state = *juce::dsp::IIR::Coefficients<float>::makeHighShelf (
-        sampleRate, 12000.0f, 0.707f, airGain);
-    {
-        juce::dsp::ProcessContextReplacing<float> ctx (block);
-        cherryAirShelf.process (ctx);
-    }
+    return *engine;
 }
 
-void FlavorProcessor::processCherryFlat (juce::dsp::AudioBlock<float>& block)
+void FlavorProcessor::prepareProcessingState (const juce::dsp::ProcessSpec& spec)
 {
-    // FLAT: subtle chorus (1.5Hz rate, 0.5-1ms depth)
-    const auto nChannels = block.getNumChannels();
-    const auto nSamples = block.getNumSamples();
-    float fizz = smoothedFizz.getCurrentValue();
+    // SmoothedValues for Fizz and the blend morph (~20ms ramp)
+    smoothedFizz.reset (spec.sampleRate, 0.02);
+    smoothedFizz.setCurrentAndTargetValue (0.5f);
+    smoothedMorph.reset (spec.sampleRate, 0.02);
+    smoothedMorph.setCurrentAndTargetValue (blendParam->get() ? blendMorphParam->get() * 0.01f : 0.0f);
+
+    preparedSpec = spec;
+    isPrepared = true;
+
+    preRollSamples = juce::roundToInt (kPreRollSeconds * spec.sampleRate);
+    historyWritePosition = 0;
+    historyNumValid = 0;
+    historyExcluded = 0;
+
+    outgoingFlavor = -1;
+    transitionRemaining = 0;
+    primaryIdle = false;
+    blendIdle = false;
+    processingDualMono = false;
+    stereoFadeRemaining = 0;
+    identicalSamples = kChannelsInSync;
+}
 
-    float chorusDepthMs = FizzCurves::sCurve (fizz, 0.5f, 1.0f);
-    float chorusRate = 1.5f;
-    float chorusMix = 0.3f;
+void FlavorProcessor::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    const juce::ScopedLock sl (preparationLock);
+    prepareProcessingState (spec);
+    allocateHistory();
 
-    float depthSamples = static_cast<float>(chorusDepthMs * 0.001 * sampleRate);
-    float baseDelaySamples = static_cast<float>(3.0 * 0.001 * sampleRate); // 3ms base
-    float phaseInc = static_cast<float>(chorusRate * 2.0 * juce::MathConstants<double>::pi / sampleRate);
-    int bufferSize = cherryChorusDelayBuffer.getNumSamples();
+    // Warm standby: only the selected flavor (and the blend flavor, if Blend
+    // is on) is prepared here. The others are released and rebuilt in the
+    // background if they are selected again (offline, the render waits).
+    activeFlavor = getSelectedFlavorIndex();
+    blendFlavor = blendParam->get() ? blendFlavorParam->getIndex() : -1;
+    if (blendFlavor == activeFlavor)
+        blendFlavor = -1;
 
-    for (size_t ch = 0; ch < nChannels; ++ch)
+    for (int i = 0; i < kNumFlavors; ++i)
     {
-        auto* data = block.getChannelPointer (ch);
-        auto* delayData = cherryChorusDelayBuffer.getWritePointer (static_cast<int>(ch));
+        auto& slot = slots[static_cast<size_t> (i)];
 
-        for (size_t i = 0; i < nSamples; ++i)
+        if (i == activeFlavor || i == blendFlavor)
         {
-            int wp = (cherryChorusWritePos + static_cast<int>(i)) % bufferSize;
-            delayData[wp] = data[i];
+            prepareEngine (i);
+            slot.state.store (SlotState::Ready, std::memory_order_release);
+        }
+        else
+        {
+            slot.state.store (SlotState::Unprepared, std::memory_order_release);
+            slot.engine.reset();
+        }
+    }
+}
 
-            float mod = std::sin (cherryChorusPhase + phaseInc * static_cast<float>(i)) * depthSamples;
-            float readDelay = baseDelaySamples + mod;
-            float readPos = static_cast<float>(wp) - readDelay;
-            if (readPos < 0.0f) readPos += static_cast<float>(bufferSize);
+void FlavorProcessor::prepareDeferred (const juce::dsp::ProcessSpec& spec)
+{
+    const juce::ScopedLock sl (preparationLock);
+    prepareProcessingState (spec);
 
-            int readIdx = static_cast<int>(readPos);
-            float frac = readPos - static_cast<float>(readIdx);
-            int nextIdx = (readIdx + 1) % bufferSize;
-            float delayed = delayData[readIdx] * (1.0f - frac) + delayData[nextIdx] * frac;
+    activeFlavor = -1;
+    blendFlavor = -1;
+    inputHistory.setSize (0, 0);   // Allocated with the first engine
 
-            data[i] = data[i] * (1.0f - chorusMix) + delayed * chorusMix;
-        }
+    for (auto& slot : slots)
+    {
+        slot.state.store (SlotState::Unprepared, std::memory_order_release);
+        slot.engine.reset();
     }
+}
+
+bool FlavorProcessor::activate()
+{
+    if (activeFlavor >= 0)
+        return true;
+
+    const int selected = getSelectedFlavorIndex();
+    if (! requestFlavor (selected))
+        return false;
 
-    cherryChorusWritePos = (cherryChorusWritePos + static_cast<int>(nSamples)) % bufferSize;
-    cherryChorusPhase += phaseInc * static_cast<float>(nSamples);
-    if (cherryChorusPhase > juce::MathConstants<float>::twoPi)
-        cherryChorusPhase -= juce::MathConstants<float>::twoPi;
+    warmUp (selected);
+    activeFlavor = selected;
+    return true;
 }
 
-// =============================================================================
-// GRAPE — Lo-Fi Tape Texture
-// =============================================================================
-void FlavorProcessor::processGrape (juce::dsp::AudioBlock<float>& block)
+void FlavorProcessor::prepareRequestedFlavors()
 {
-    const auto nChannels = block.getNumChannels();
-    const auto nSamples = block.getNumSamples();
-    float fizz = smoothedFizz.getCurrentValue();
-
-    // Fizz-morphed parameters (shaped curves)
-    float tapeDrive   = FizzCurves::exponential (fizz, 1.2f, 4.0f, 2.5f);
-    float wowDepthMs  = FizzCurves::exponential (fizz, 0.0f, 3.0f, 2.0f);
-    float flutDepthMs = FizzCurves::exponential (fizz, 0.0f, 0.5f, 2.0f);
-    float lpCutoff    = FizzCurves::logarithmic (fizz, 16000.0f, 4000.0f, 2.0f);
-
-    // 1. Oversampled tape saturation with DC bias
-    SaturationEngine::Params satParams;
-    satParams.curve = SaturationEngine::CurveType::Tanh;
-    satParams.drive = tapeDrive;
-    satParams.dcBias = 0.15f;
-    saturationEngine.process (block, satParams);
-
-    // DC block
-    {
-        juce::dsp::ProcessContextReplacing<float> ctx (block);
-        grapeDCBlocker.process (ctx);
-    }
+    const juce::ScopedLock sl (preparationLock);
 
-    // 2. Wow & Flutter via modulated delay
-    float baseDelayMs = 5.0f;
-    float baseDelaySamples = static_cast<float>(baseDelayMs * 0.001 * sampleRate);
-    float wowDepthSamples = static_cast<float>(wowDepthMs * 0.001 * sampleRate);
-    float flutDepthSamples = static_cast<float>(flutDepthMs * 0.001 * sampleRate);
-    float wowPhaseInc = static_cast<float>(0.4 * 2.0 * juce::MathConstants<double>::pi / sampleRate);
-    float flutPhaseInc = static_cast<float>(4.5 * 2.0 * juce::MathConstants<double>::pi / sampleRate);
-    int delBufSize = grapeDelayBuffer.getNumSamples();
+    if (! isPrepared)
+        return;
 
-    for (size_t ch = 0; ch < nChannels; ++ch)
+    for (int i = 0; i < kNumFlavors; ++i)
     {
-        auto* data = block.getChannelPointer (ch);
-        auto* delData = grapeDelayBuffer.getWritePointer (static_cast<int>(ch));
+        auto& slot = slots[static_cast<size_t> (i)];
 
-        for (size_t i = 0; i < nSamples; ++i)
-        {
-            int wp = (grapeDelayWritePos + static_cast<int>(i)) % delBufSize;
-            delData[wp] = data[i];
+        if (slot.state.load (std::memory_order_acquire) != SlotState::Requested)
+            continue;
 
-            float wowMod = std::sin (grapeWowPhase + wowPhaseInc * static_cast<float>(i)) * wowDepthSamples;
-            float flutPhase = grapeFlutterPhase + flutPhaseInc * static_cast<float>(i);
-            float flutMod = (2.0f / juce::MathConstants<float>::pi) *
-                            std::asin (std::sin (flutPhase)) * flutDepthSamples;
+        // Requested slots are never touched by the audio thread, and neither
+        // is the history until the first engine is Ready (see activate())
+        if (inputHistory.getNumSamples() == 0)
+            allocateHistory();
 
-            float totalDelay = baseDelaySamples + wowMod + flutMod;
-            totalDelay = juce::jlimit (1.0f, static_cast<float>(delBufSize - 2), totalDelay);
+        prepareEngine (i);
+        slot.state.store (SlotState::Ready, std::memory_order_release);
+    }
 
-            float readPos = static_cast<float>(wp) - totalDelay;
-            if (readPos < 0.0f) readPos += static_cast<float>(delBufSize);
+    // Oversampling variants the running engines switched to
+    for (auto& slot : slots)
+        if (slot.state.load (std::memory_order_acquire) == SlotState::Ready)
+            slot.engine->buildRequestedOversampler();
+}
 
-            int readIdx = static_cast<int>(readPos);
-            float frac = readPos - static_cast<float>(readIdx);
-            int nextIdx = (readIdx + 1) % delBufSize;
-            data[i] = delData[readIdx] * (1.0f - frac) + delData[nextIdx] * frac;
-        }
-    }
+void FlavorProcessor::prepareEngine (int flavor)
+{
+    // Settings first, so prepare() builds the oversampling variant in use
+    auto& engine = createEngine (flavor);
+    applySettings (engine);
+    engine.prepare (preparedSpec);
+}
 
-    grapeDelayWritePos = (grapeDelayWritePos + static_cast<int>(nSamples)) % delBufSize;
-    grapeWowPhase += wowPhaseInc * static_cast<float>(nSamples);
-    grapeFlutterPhase += flutPhaseInc * static_cast<float>(nSamples);
-    if (grapeWowPhase > juce::MathConstants<float>::twoPi)
-        grapeWowPhase -= juce::MathConstants<float>::twoPi;
-    if (grapeFlutterPhase > juce::MathConstants<float>::twoPi)
-        grapeFlutterPhase -= juce::MathConstants<float>::twoPi;
+bool FlavorProcessor::requestFlavor (int flavor)
+{
+    auto& slot = slots[static_cast<size_t> (flavor)];
+    auto state = slot.state.load (std::memory_order_acquire);
 
-    // 3. Tape head LP filter
-    grapeTapeLP.setCutoffFrequency (lpCutoff);
+    if (state == SlotState::Unprepared)
+        slot.state.compare_exchange_strong (state, SlotState::Requested, std::memory_order_acq_rel);
+
+    // Nothing is real-time offline: the render waits, so the switch still
+    // lands on the block it was automated at
+    if (renderOffline)
     {
-        juce::dsp::ProcessContextReplacing<float> ctx (block);
-        grapeTapeLP.process (ctx);
+        while (slot.state.load (std::memory_order_acquire) != SlotState::Ready)
+            preparationThread->waitForPass();
+
+        return true;
     }
 
+    return state == SlotState::Ready;
 }
 
-void FlavorProcessor::processGrapeFlat (juce::dsp::AudioBlock<float>& block)
+void FlavorProcessor::process (juce::dsp::ProcessContextReplacing<float>& context)
 {
-    // FLAT: Vinyl mode — crackle + rumble + mono below 300Hz
-    processGrape (block);
+    if (activeFlavor < 0)
+        return;
 
-    const auto nChannels = block.getNumChannels();
-    const auto nSamples = block.getNumSamples();
-    float fizz = smoothedFizz.getCurrentValue();
+    historyExcluded = 0;   // Engines warmed up from here on see the input up to this block
 
-    // Vinyl crackle (sparse random pops)
-    float crackleRate = FizzCurves::exponential (fizz, 0.001f, 0.01f, 2.0f);
-    float crackleLevel = FizzCurves::exponential (fizz, 0.01f, 0.05f, 2.0f);
-    for (size_t ch = 0; ch < nChannels; ++ch)
+    // Flavor change: switch once the selected engine is ready, otherwise ask
+    // for it and keep running the current one. A running fade finishes first.
+    const int selected = getSelectedFlavorIndex();
+
+    if (selected != activeFlavor && outgoingFlavor < 0 && requestFlavor (selected))
     {
-        auto* data = block.getChannelPointer (ch);
-        for (size_t i = 0; i < nSamples; ++i)
-        {
-            if (grapeNoiseRNG.nextFloat() < crackleRate)
-                data[i] += (grapeNoiseRNG.nextFloat() * 2.0f - 1.0f) * crackleLevel;
-        }
+        if (selected == blendFlavor)
+            blendFlavor = -1;   // Moves from the blend slot to the main one
+
+        beginTransition (selected);
     }
 
-    // 40Hz rumble
-    float rumbleLevel = FizzCurves::exponential (fizz, 0.0f, 0.015f, 2.0f);
-    for (size_t ch = 0; ch < nChannels; ++ch)
+    // Blend: turning it off fades the morph back to 0 before the engine stops
+    const bool blendWanted = blendParam->get();
+    const bool swappingBlend = updateBlendFlavor (blendWanted);
+    smoothedMorph.setTargetValue (blendWanted && ! swappingBlend ? blendMorphParam->get() * 0.01f : 0.0f);
+
+    auto& block = context.getOutputBlock();
+    const auto nChannels = block.getNumChannels();
+    const auto nSamples = block.getNumSamples();
+    jassert (nSamples <= static_cast<size_t> (preparedSpec.maximumBlockSize));
+
+    writeHistory (block);
+
+    const ScratchArena::Scope scope (scratch);
+
+    // Dual mono: identical inputs through symmetric engines give identical
+    // outputs — run channel 0 only and copy it
+    const bool identical = hasIdenticalChannels (block);
+    const bool dualMono = identical && canProcessDualMono();
+    identicalSamples = identical ? identicalSamples + static_cast<juce::int64> (nSamples) : 0;
+    if (processingDualMono && ! dualMono)
+        resumeStereo (nChannels);
+    processingDualMono = dualMono;
+
+    if (dualMono)
     {
-        auto* data = block.getChannelPointer (ch);
-        for (size_t i = 0; i < nSamples; ++i)
-        {
-            float noise = (grapeNoiseRNG.nextFloat() * 2.0f - 1.0f) * rumbleLevel;
-            data[i] += noise;
-        }
+        auto mono = block.getSingleChannelBlock (0);
+        processEngines (mono, blendWanted);
+
+        for (size_t ch = 1; ch < nChannels; ++ch)
+            juce::FloatVectorOperations::copy (block.getChannelPointer (ch), mono.getChannelPointer (0),
+                                               static_cast<int> (nSamples));
+        return;
     }
 
-    // Mono below 300Hz (stereo only)
-    if (nChannels >= 2)
+    processEngines (block, blendWanted);
+
+    if (stereoFadeRemaining > 0)
     {
-        auto* dataL = block.getChannelPointer (0);
-        auto* dataR = block.getChannelPointer (1);
-        for (size_t i = 0; i < nSamples; ++i)
+        // Just left dual mono: channels 1+ go from channel 0's output (what
+        // they played so far) to their own, while state the engines couldn't
+        // copy (JUCE oversamplers, compressor envelopes) catches up
+        const auto numFading = juce::jmin (nSamples, static_cast<size_t> (stereoFadeRemaining));
+        const float step = 1.0f / static_cast<float> (stereoFadeLength);
+        const float startGain = 1.0f - static_cast<float> (stereoFadeRemaining) * step;
+        const auto* mono = block.getChannelPointer (0);
+
+        for (size_t ch = 1; ch < nChannels; ++ch)
         {
-            float mid = (dataL[i] + dataR[i]) * 0.5f;
-            float sideL = dataL[i] - mid;
-            float sideR = dataR[i] - mid;
-            dataL[i] = mid + sideL;
-            dataR[i] = mid + sideR;
+            auto* out = block.getChannelPointer (ch);
+
+            for (size_t i = 0; i < numFading; ++i)
+            {
+                const float gain = startGain + static_cast<float> (i) * step;
+                out[i] = mono[i] + gain * (out[i] - mono[i]);
+            }
         }
+
+        stereoFadeRemaining -= static_cast<int> (numFading);
     }
 }
 
-// =============================================================================
-// LEMON-LIME — Crisp Exciter
-// =============================================================================
-void FlavorProcessor::processLemonLime (juce::dsp::AudioBlock<float>& block)
+void FlavorProcessor::processEngines (juce::dsp::AudioBlock<float>& block, bool blendWanted)
 {
-    const auto nChannels = block.getNumChannels();
     const auto nSamples = block.getNumSamples();
-    float fizz = smoothedFizz.getCurrentValue();
 
-    // Fizz-morphed parameters (shaped curves)
-    float crossoverFreq = FizzCurves::logarithmic (fizz, 4000.0f, 1500.0f, 2.0f);
-    float hfDrive       = FizzCurves::exponential (fizz, 1.3f, 3.5f, 2.5f);
-    float presDb        = FizzCurves::logarithmic (fizz, 0.5f, 6.0f, 1.8f);
-    float airDb         = FizzCurves::logarithmic (fizz, 0.5f, 5.0f, 1.8f);
-    float compAttack    = FizzCurves::exponential (fizz, 10.0f, 0.5f, 2.0f);
+    const bool morphSettled = ! smoothedMorph.isSmoothing();
+    const float morph = smoothedMorph.getCurrentValue();
+    const bool runBlend = blendFlavor >= 0 && ! (morphSettled && morph <= 0.0f);
+    const bool runPrimary = ! (runBlend && morphSettled && morph >= 1.0f && outgoingFlavor < 0);
 
-    // 1. True Linkwitz-Riley 4th-order crossover (cascaded 2nd-order)
-    lemonLowBandBuffer.setSize (static_cast<int>(nChannels), static_cast<int>(nSamples), false, false, true);
-    for (size_t ch = 0; ch < nChannels; ++ch)
-        lemonLowBandBuffer.copyFrom (static_cast<int>(ch), 0,
-                                     block.getChannelPointer (ch),
-                                     static_cast<int>(nSamples));
-
-    // Low-pass through two cascaded stages (LR4)
-    lemonLowPass1.setCutoffFrequency (crossoverFreq);
-    lemonLowPass2.setCutoffFrequency (crossoverFreq);
-    {
-        juce::dsp::AudioBlock<float> lowBlock (lemonLowBandBuffer);
-        juce::dsp::ProcessContextReplacing<float> ctx (lowBlock);
-        lemonLowPass1.process (ctx);
-    }
+    if (runPrimary && primaryIdle)
     {
-        juce::dsp::AudioBlock<float> lowBlock (lemonLowBandBuffer);
-        juce::dsp::ProcessContextReplacing<float> ctx (lowBlock);
-        lemonLowPass2.process (ctx);
+        // Resuming after being skipped: settled on the input it missed
+        warmUp (activeFlavor);
+        primaryIdle = false;
     }
 
-    // High-pass through two cascaded stages (LR4)
-    lemonHighPass1.setCutoffFrequency (crossoverFreq);
-    lemonHighPass2.setCutoffFrequency (crossoverFreq);
+    if (! runBlend)
     {
-        juce::dsp::ProcessContextReplacing<float> ctx (block);
-        lemonHighPass1.process (ctx);
-    }
-    {
-        juce::dsp::ProcessContextReplacing<float> ctx (block);
-        lemonHighPass2.process (ctx);
+        // Blend off and faded out: release the slot so re-engaging starts clean
+        if (! blendWanted)
+            blendFlavor = -1;
+        blendIdle = blendFlavor >= 0;
+
+        smoothedMorph.skip (static_cast<int> (nSamples));
+        processPrimary (block);
+        return;
     }
 
-    // 2. Oversampled HF band saturation via SaturationEngine
-    SaturationEngine::Params satParams;
-    satParams.curve = SaturationEngine::CurveType::Tanh;
-    satParams.drive = hfDrive;
-    satParams.outputGain = 1.0f / hfDrive;
-    saturationEngine.process (block, satParams);
-
-    // 3. Fast envelope compressor on HF
-    lemonHFCompressor.setRatio (4.0f);
-    lemonHFCompressor.setThreshold (-20.0f);
-    lemonHFCompressor.setAttack (compAttack);
-    lemonHFCompressor.setRelease (50.0f);
+    // ─── Blend: second engine on a copy of the input, same Fizz ramp ──
+    const auto nChannels = juce::jmin (block.getNumChannels(), static_cast<size_t> (preparedSpec.numChannels));
+
+    auto blendBlock = scratch.allocateBlock (nChannels, nSamples);
+    blendBlock.copyFrom (block);
+
+    if (blendIdle)
     {
-        juce::dsp::ProcessContextReplacing<float> ctx (block);
-        lemonHFCompressor.process (ctx);
+        warmUp (blendFlavor);
+        blendIdle = false;
     }
 
-    // 4. Presence bell @ 5kHz
-    float presGain = juce::Decibels::decibelsToGain (presDb);
-    *lemonPresence.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter (
-        sampleRate, 5000.0f, 1.5f, presGain);
+    auto blendFizz = smoothedFizz;
+    processFlavor (blendFlavor, blendBlock, blendFizz);
+
+    if (! runPrimary)
     {
-        juce::dsp::ProcessContextReplacing<float> ctx (block);
-        lemonPresence.process (ctx);
+        // Morph settled at 1: the main flavor is skipped entirely
+        primaryIdle = true;
+        smoothedFizz.skip (static_cast<int> (nSamples));
+        block.copyFrom (blendBlock);
+        return;
     }
 
-    // 5. Air shelf @ 10kHz
-    float airGain = juce::Decibels::decibelsToGain (airDb);
-    *lemonAirShelf.state = *juce::dsp::IIR::Coefficients<float>::makeHighShelf (
-        sampleRate, 10000.0f, 0.707f, airGain);
+    processPrimary (block);
+
+    // out = primary + morph * (blend - primary)
+    if (morphSettled)
     {
-        juce::dsp::ProcessContextReplacing<float> ctx (block);
-        lemonAirShelf.process (ctx);
-    }
+        smoothedMorph.skip (static_cast<int> (nSamples));
 
-    // 6. Sum LOW + HIGH (LR4 sums flat)
-    for (size_t ch = 0; ch < nChannels; ++ch)
+        for (size_t ch = 0; ch < nChannels; ++ch)
+        {
+            auto* out = block.getChannelPointer (ch);
+            juce::FloatVectorOperations::multiply (out, 1.0f - morph, static_cast<int> (nSamples));
+            juce::FloatVectorOperations::addWithMultiply (out, blendBlock.getChannelPointer (ch), morph,
+                                                          static_cast<int> (nSamples));
+        }
+    }
+    else
     {
-        auto* outData = block.getChannelPointer (ch);
-        const auto* lowData = lemonLowBandBuffer.getReadPointer (static_cast<int>(ch));
+        auto* morphRamp = scratch.allocate (nSamples);
         for (size_t i = 0; i < nSamples; ++i)
-            outData[i] += lowData[i];
+            morphRamp[i] = smoothedMorph.getNextValue();
+
+        for (size_t ch = 0; ch < nChannels; ++ch)
+        {
+            auto* out = block.getChannelPointer (ch);
+            const auto* other = blendBlock.getChannelPointer (ch);
+
+            for (size_t i = 0; i < nSamples; ++i)
+                out[i] += morphRamp[i] * (other[i] - out[i]);
+        }
     }
 }
 
-void FlavorProcessor::processLemonLimeFlat (juce::dsp::AudioBlock<float>& block)
+bool FlavorProcessor::canProcessDualMono() const noexcept
 {
-    // FLAT: Telephone EQ — bandpass 300Hz–3.5kHz with resonant peaks
-    float fizz = smoothedFizz.getCurrentValue();
-    float resonance = FizzCurves::exponential (fizz, 0.707f, 3.0f, 2.0f);
-
-    *lemonTeleBandpass.state = *juce::dsp::IIR::Coefficients<float>::makeHighPass (
-        sampleRate, 300.0f, resonance);
-    *lemonTeleHighCut.state = *juce::dsp::IIR::Coefficients<float>::makeLowPass (
-        sampleRate, 3500.0f, resonance);
+    // The oversamplers' filters remember about twice their latency
+    double settleSamples = 2.0 * getLatencyInSamples (carbonatedState);
 
+    const auto& descriptors = FlavorRegistry::getDescriptors();
+    for (const int flavor : { activeFlavor, outgoingFlavor, blendFlavor })
     {
-        juce::dsp::ProcessContextReplacing<float> ctx (block);
-        lemonTeleBandpass.process (ctx);
-    }
-    {
-        juce::dsp::ProcessContextReplacing<float> ctx (block);
-        lemonTeleHighCut.process (ctx);
+        if (flavor < 0)
+            continue;
+
+        const auto& descriptor = descriptors[static_cast<size_t> (flavor)];
+        if (! descriptor.isChannelSymmetric (carbonatedState))
+            return false;
+
+        settleSamples = juce::jmax (settleSamples, 2.0 * getLatencyInSamples (carbonatedState)
+                                                   + descriptor.getTailLengthSeconds (carbonatedState) * preparedSpec.sampleRate);
     }
+
+    // Already running dual mono, the channels' states are one and the same
+    return processingDualMono || static_cast<double> (identicalSamples) >= settleSamples;
 }
 
-// =============================================================================
-// ORANGE CREAM — Lowpass Filter + Drive (OneKnob Filter style)
-// =============================================================================
-void FlavorProcessor::processOrangeCream (juce::dsp::AudioBlock<float>& block)
+bool FlavorProcessor::hasIdenticalChannels (const juce::dsp::AudioBlock<float>& block) noexcept
 {
-    const auto nSamples = block.getNumSamples();
-    float fizz = smoothedFizz.getCurrentValue();
-
-    // Fizz-morphed parameters
-    // Drive: gentle warmth that increases as you close the filter
-    float drive      = FizzCurves::exponential (fizz, 1.0f, 2.5f, 2.0f);
-    // LP cutoff sweeps from wide open down to 200Hz
-    float lpCutoff   = FizzCurves::logarithmic (fizz, 20000.0f, 200.0f, 2.5f);
-    // Resonance adds filter character as it closes
-    float resonance  = FizzCurves::sCurve (fizz, 0.707f, 2.5f);
-    // Low shelf boost keeps the bass full as highs are removed
-    float lowBoostDb = FizzCurves::logarithmic (fizz, 0.0f, 4.0f, 1.8f);
-
-    // Advance smoothed fizz for the block
-    for (size_t i = 0; i < nSamples; ++i)
-        smoothedFizz.getNextValue();
-
-    // 1. Warm drive saturation (pre-filter for analog character)
-    SaturationEngine::Params satParams;
-    satParams.curve = SaturationEngine::CurveType::WarmClip;
-    satParams.drive = drive;
-    saturationEngine.process (block, satParams);
-
-    // 2. Resonant lowpass filter (4th-order: two cascaded SVTPF stages)
-    //    Stage 1: resonant — provides the filter sweep character
-    //    Stage 2: fixed Q — adds steepness for a 24dB/oct rolloff
-    orangeLP1.setCutoffFrequency (lpCutoff);
-    orangeLP1.setResonance (resonance);
-    orangeLP2.setCutoffFrequency (lpCutoff);
-    orangeLP2.setResonance (0.707f);
+    const auto nChannels = block.getNumChannels();
+    if (nChannels < 2)
+        return false;
+
+    // Bit-identical: memcmp stops at the first difference, so true stereo
+    // costs next to nothing to rule out
+    const auto numBytes = block.getNumSamples() * sizeof (float);
+    const auto* first = block.getChannelPointer (0);
+
+    for (size_t ch = 1; ch < nChannels; ++ch)
+        if (std::memcmp (first, block.getChannelPointer (ch), numBytes) != 0)
+            return false;
+
+    return true;
+}
+
+void FlavorProcessor::resumeStereo (size_t numChannels)
+{
+    numChannels = juce::jmin (numChannels, static_cast<size_t> (preparedSpec.numChannels));
+
+    for (const int flavor : { activeFlavor, outgoingFlavor, blendFlavor })
+        if (flavor >= 0)
+            for (size_t ch = 1; ch < numChannels; ++ch)
+                slots[static_cast<size_t> (flavor)].engine->copyChannelState (0, ch);
+
+    stereoFadeLength = juce::roundToInt (transitionSeconds * preparedSpec.sampleRate);
+    stereoFadeRemaining = stereoFadeLength;
+}
+
+bool FlavorProcessor::updateBlendFlavor (bool blendWanted)
+{
+    if (! blendWanted)
+        return false;   // Keep the engaged engine while the morph fades out
+
+    const int selected = juce::jlimit (0, kNumFlavors - 1, blendFlavorParam->getIndex());
+
+    // The same flavor in both slots is just that flavor; an engine can't
+    // run twice per block, so wait out a transition that still uses it
+    if (selected == activeFlavor)
     {
-        juce::dsp::ProcessContextReplacing<float> ctx (block);
-        orangeLP1.process (ctx);
+        blendFlavor = -1;
+        return false;
     }
+
+    if (selected == blendFlavor || selected == outgoingFlavor || ! requestFlavor (selected))
+        return false;
+
+    // Swapping the blend flavor: fade the old one out first
+    if (blendFlavor >= 0 && (smoothedMorph.isSmoothing() || smoothedMorph.getCurrentValue() > 0.0f))
+        return true;
+
+    warmUp (selected);
+    blendFlavor = selected;
+    blendIdle = false;
+
+    // A newly engaged (or swapped) blend flavor always fades in from 0
+    smoothedMorph.setCurrentAndTargetValue (0.0f);
+    return false;
+}
+
+void FlavorProcessor::processPrimary (juce::dsp::AudioBlock<float>& block)
+{
+    if (outgoingFlavor < 0)
     {
-        juce::dsp::ProcessContextReplacing<float> ctx (block);
-        orangeLP2.process (ctx);
+        processFlavor (activeFlavor, block, smoothedFizz);
+        return;
     }
 
-    // 3. Low shelf boost @ 200Hz to keep the low end full
-    float lowBoostGain = juce::Decibels::decibelsToGain (lowBoostDb);
-    *orangeLowShelf.state = *juce::dsp::IIR::Coefficients<float>::makeLowShelf (
-        sampleRate, 200.0f, 0.707f, lowBoostGain);
+    // ─── Transition: both engines, then a linear crossfade ─────
+    const auto nChannels = juce::jmin (block.getNumChannels(), static_cast<size_t> (preparedSpec.numChannels));
+    const auto nSamples = block.getNumSamples();
+
+    // Released with the caller's scope (process())
+    auto outgoingBlock = scratch.allocateBlock (nChannels, nSamples);
+    outgoingBlock.copyFrom (block);
+
+    // Both engines follow the same Fizz ramp
+    auto outgoingFizz = smoothedFizz;
+    processFlavor (outgoingFlavor, outgoingBlock, outgoingFizz);
+    processFlavor (activeFlavor, block, smoothedFizz);
+
+    const auto numFading = juce::jmin (nSamples, static_cast<size_t> (transitionRemaining));
+    const float step = 1.0f / static_cast<float> (transitionLength);
+    const float startGain = 1.0f - static_cast<float> (transitionRemaining) * step;
+
+    for (size_t ch = 0; ch < nChannels; ++ch)
     {
-        juce::dsp::ProcessContextReplacing<float> ctx (block);
-        orangeLowShelf.process (ctx);
+        auto* incoming = block.getChannelPointer (ch);
+        const auto* outgoing = outgoingBlock.getChannelPointer (ch);
+
+        for (size_t i = 0; i < numFading; ++i)
+        {
+            const float gain = startGain + static_cast<float> (i) * step;
+            incoming[i] = outgoing[i] + gain * (incoming[i] - outgoing[i]);
+        }
     }
+
+    transitionRemaining -= static_cast<int> (numFading);
+    if (transitionRemaining == 0)
+        outgoingFlavor = -1;
 }
 
-void FlavorProcessor::processOrangeCreamFlat (juce::dsp::AudioBlock<float>& block)
+void FlavorProcessor::beginTransition (int incomingFlavor)
 {
-    // FLAT: dirtier version — heavier drive, more resonance, filter goes lower
-    const auto nSamples = block.getNumSamples();
-    float fizz = smoothedFizz.getCurrentValue();
-
-    // More aggressive parameters for the dirty version
-    float drive      = FizzCurves::exponential (fizz, 1.5f, 4.0f, 2.0f);
-    float lpCutoff   = FizzCurves::logarithmic (fizz, 20000.0f, 100.0f, 2.5f);
-    float resonance  = FizzCurves::sCurve (fizz, 0.707f, 4.0f);
-    float lowBoostDb = FizzCurves::logarithmic (fizz, 0.0f, 6.0f, 1.8f);
-
-    // 1. Heavier tanh saturation (grittier than WarmClip)
-    SaturationEngine::Params satParams;
-    satParams.curve = SaturationEngine::CurveType::Tanh;
-    satParams.drive = drive;
-    saturationEngine.process (block, satParams);
-
-    // 2. Resonant lowpass filter (4th-order, both stages resonant for aggression)
-    orangeLP1.setCutoffFrequency (lpCutoff);
-    orangeLP1.setResonance (resonance);
-    orangeLP2.setCutoffFrequency (lpCutoff);
-    orangeLP2.setResonance (resonance * 0.5f);
+    // Pre-warm: current settings, no stale state from the flavor's last use,
+    // then settled on the input leading up to the switch
+    warmUp (incomingFlavor);
+
+    const int length = juce::roundToInt (transitionSeconds * preparedSpec.sampleRate);
+    if (length > 0 && ! primaryIdle)
     {
-        juce::dsp::ProcessContextReplacing<float> ctx (block);
-        orangeLP1.process (ctx);
+        outgoingFlavor = activeFlavor;
+        transitionLength = length;
+        transitionRemaining = length;
     }
+
+    activeFlavor = incomingFlavor;
+    primaryIdle = false;
+}
+
+void FlavorProcessor::warmUp (int flavor)
+{
+    auto& engine = *slots[static_cast<size_t> (flavor)].engine;
+    applySettings (engine);
+    engine.reset();
+
+    const int capacity = inputHistory.getNumSamples();
+    const int numPreRoll = juce::jmin (preRollSamples, historyNumValid - historyExcluded);
+    if (numPreRoll <= 0)
+        return;
+
+    // Fizz held where it is now; the engine's own morph state follows it
+    auto fizz = smoothedFizz;
+    fizz.setCurrentAndTargetValue (smoothedFizz.getCurrentValue());
+
+    const auto nChannels = static_cast<size_t> (inputHistory.getNumChannels());
+    const int maxChunk = static_cast<int> (preparedSpec.maximumBlockSize);
+    int readPosition = (historyWritePosition - historyExcluded - numPreRoll + capacity) % capacity;
+
+    for (int done = 0; done < numPreRoll;)
     {
-        juce::dsp::ProcessContextReplacing<float> ctx (block);
-        orangeLP2.process (ctx);
+        const int numThisTime = juce::jmin (maxChunk, numPreRoll - done);
+        const int numBeforeWrap = juce::jmin (numThisTime, capacity - readPosition);
+
+        const ScratchArena::Scope scope (scratch);
+        auto chunk = scratch.allocateBlock (nChannels, static_cast<size_t> (numThisTime));
+
+        for (size_t ch = 0; ch < nChannels; ++ch)
+        {
+            const auto* history = inputHistory.getReadPointer (static_cast<int> (ch));
+            auto* dest = chunk.getChannelPointer (ch);
+            juce::FloatVectorOperations::copy (dest, history + readPosition, numBeforeWrap);
+            juce::FloatVectorOperations::copy (dest + numBeforeWrap, history, numThisTime - numBeforeWrap);
+        }
+
+        processFlavor (flavor, chunk, fizz);
+
+        done += numThisTime;
+        readPosition = (readPosition + numThisTime) % capacity;
     }
+}
+
+void FlavorProcessor::allocateHistory()
+{
+    inputHistory.setSize (static_cast<int> (preparedSpec.numChannels),
+                          preRollSamples + static_cast<int> (preparedSpec.maximumBlockSize));
+    inputHistory.clear();
+}
+
+void FlavorProcessor::writeHistory (const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    const int capacity = inputHistory.getNumSamples();
+    const auto nChannels = juce::jmin (block.getNumChannels(), static_cast<size_t> (inputHistory.getNumChannels()));
+    const int nSamples = juce::jmin (static_cast<int> (block.getNumSamples()), capacity);
+    if (nSamples == 0)
+        return;
 
-    // 3. Low shelf boost to fatten up the bottom end
-    float lowBoostGain = juce::Decibels::decibelsToGain (lowBoostDb);
-    *orangeLowShelf.state = *juce::dsp::IIR::Coefficients<float>::makeLowShelf (
-        sampleRate, 200.0f, 0.707f, lowBoostGain);
+    const int numBeforeWrap = juce::jmin (nSamples, capacity - historyWritePosition);
+
+    for (size_t ch = 0; ch < nChannels; ++ch)
     {
-        juce::dsp::ProcessContextReplacing<float> ctx (block);
-        orangeLowShelf.process (ctx);
+        const auto* src = block.getChannelPointer (ch);
+        auto* history = inputHistory.getWritePointer (static_cast<int> (ch));
+        juce::FloatVectorOperations::copy (history + historyWritePosition, src, numBeforeWrap);
+        juce::FloatVectorOperations::copy (history, src + numBeforeWrap, nSamples - numBeforeWrap);
     }
+
+    historyWritePosition = (historyWritePosition + nSamples) % capacity;
+    historyNumValid = juce::jmin (historyNumValid + nSamples, capacity);
+    historyExcluded = nSamples;
+}
+
+void FlavorProcessor::recordInput (const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    if (activeFlavor < 0)
+        return;
+
+    writeHistory (block);
+    historyExcluded = 0;   // Nothing of it is being processed
+}
+
+void FlavorProcessor::restart()
+{
+    const int numRecorded = historyNumValid;
+    reset();
+    historyNumValid = numRecorded;
+    smoothedFizz.setCurrentAndTargetValue (smoothedFizz.getTargetValue());   // No ramp from before the pause
+
+    if (activeFlavor >= 0 && ! primaryIdle)
+        warmUp (activeFlavor);
+
+    if (blendFlavor >= 0 && ! blendIdle)
+        warmUp (blendFlavor);
+}
+
+void FlavorProcessor::processFlavor (int flavor, juce::dsp::AudioBlock<float>& block, juce::SmoothedValue<float>& fizz)
+{
+    // One indirect call per host block; the control-rate loop and every stage
+    // of the flavor are compiled together for this Carbonated state
+    const auto& descriptor = FlavorRegistry::getDescriptors()[static_cast<size_t> (flavor)];
+    descriptor.process[carbonatedState ? 1 : 0] (*slots[static_cast<size_t> (flavor)].engine,
+                                                 block, fizz, controlBlockSize);
+}
+
+void FlavorProcessor::reset()
+{
+    outgoingFlavor = -1;
+    transitionRemaining = 0;
+    processingDualMono = false;
+    stereoFadeRemaining = 0;
+    identicalSamples = kChannelsInSync;
+    historyNumValid = 0;
+    historyExcluded = 0;
+
+    for (auto& slot : slots)
+        if (slot.state.load (std::memory_order_acquire) == SlotState::Ready)
+            slot.engine->reset();
 }
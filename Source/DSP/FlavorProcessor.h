@@ -3,112 +3,279 @@
 #include <juce_dsp/juce_dsp.h>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "Parameters/ParameterIDs.h"
-#include "SaturationEngine.h"
+#include "Flavors/FlavorRegistry.h"
 
 /**
  * Flavor effect processor v2.0
  * 5 flavors, each with distinct DSP chain and multi-parameter Fizz morphing.
  * Carbonated toggle provides per-flavor alternate mode.
+ * Every flavor is its own engine type (see Flavors/); each flavor x Carbonated
+ * combination is a separately compiled process loop, selected once per host
+ * block from FlavorRegistry — nothing is dispatched per control block or per sample.
+ *
+ * Engines are created and prepared on first use: prepare() only readies the
+ * selected flavor (the warm standby). Selecting another flavor asks a shared
+ * background thread to build it, and the current flavor keeps playing until
+ * the new one is ready — the audio thread never allocates or prepares.
+ * Offline renders do the same, but the render thread waits for the engine
+ * (or oversampling variant), so a switch always lands on the block it was
+ * automated at and bounces are reproducible — without building flavors the
+ * render never reaches.
+ * The switch itself is a short crossfade, and both engines run only for the
+ * length of the fade. Before it starts, the incoming engine is reset and
+ * pre-rolled on the last kPreRollSeconds of input (output discarded), so it
+ * enters the fade already settled. By then the 5 Hz DC blockers have seen
+ * two of their ~45 ms time constants of the signal, delay lines (Grape's
+ * wow & flutter) are full, and compressor envelopes have attacked. Blend
+ * engines being engaged or resumed are pre-rolled the same way.
+ * Blend mode runs a second flavor slot in parallel and morphs between the
+ * two outputs; an engine whose weight is settled at 0 is not run at all.
+ * Every temporary buffer (transition, blend, the engines' own) is taken from
+ * the owner's ScratchArena, which must hold getScratchBytes() for the spec.
+ * Dual mono: once every channel has been bit-identical (a mono source on a
+ * stereo track) for longer than the flavors' tail — so whatever the channels
+ * played differently before has died away — and every running flavor is
+ * channel-symmetric, the engines only process channel 0 and the result is
+ * copied to the others.
+ * When the channels part again, the engines' channel 0 state is copied to
+ * the others and they fade from the mono result to their own output.
  */
 class FlavorProcessor
 {
 public:
-    FlavorProcessor (juce::AudioProcessorValueTreeState& apvts);
+    FlavorProcessor (juce::AudioProcessorValueTreeState& apvts, ScratchArena& scratch);
+    ~FlavorProcessor();
+
+    /** Scratch process() needs for blocks of up to spec.maximumBlockSize */
+    static size_t getScratchBytes (const juce::dsp::ProcessSpec& spec) noexcept;
 
     void prepare (const juce::dsp::ProcessSpec& spec);
+
+    /** As prepare(), but no engine is readied: activate() asks the background
+     *  thread for the selected flavor once the processor is actually needed.
+     *  For a path that may never run (HQ Chain), so it holds no engine memory
+     *  until then. */
+    void prepareDeferred (const juce::dsp::ProcessSpec& spec);
+
+    /** True once a flavor engine is engaged. After prepareDeferred(), requests
+     *  the selected flavor and engages it as soon as it's ready (audio thread). */
+    bool activate();
+
     void process (juce::dsp::ProcessContextReplacing<float>& context);
+
+    /** Clears every engine and the input history */
     void reset();
 
+    /** For a processor its owner has stopped calling (bypass): appends the
+     *  input it would have processed to the pre-roll history */
+    void recordInput (const juce::dsp::AudioBlock<float>& block) noexcept;
+
+    /** Resuming after recordInput() blocks: every engine is cleared, then the
+     *  running ones are pre-rolled on the recorded input (see kPreRollSeconds) */
+    void restart();
+
     /** Set the current Fizz amount (0-1) — called from EffectsChain each block */
     void setFizzAmount (float newFizz);
 
     /** Set the Carbonated state — called from EffectsChain each block */
     void setCarbonated (bool isCarbonated);
 
-    /** Toggle oversampling quality mode */
-    void setQualityMode (bool hq);
+    /** Select the saturation anti-aliasing mode (Standard / HQ / ADAA) */
+    void setQualityMode (QualityMode mode);
+
+    /** HQ oversampling factor (numStages 1-4 = 2x-16x) and half-band design.
+     *  The new variant is built on the background thread; the engines keep
+     *  running the current one until then (offline: the render waits). */
+    void setOversampling (int numStages, SaturationEngine::OversamplingFilter filter);
+
+    /** Non-realtime (offline render): flavor and oversampling switches block
+     *  until the background thread has built what they need, so they take
+     *  effect on the block they were asked for */
+    void setNonRealtime (bool isNonRealtime) { renderOffline = isNonRealtime; }
+
+    /** Exact (libm) nonlinearities instead of the fast approximations */
+    void setExactNonlinearities (bool shouldBeExact);
+
+    /** Seed of the flavors' noise sources (Grape's vinyl layer). Any thread;
+     *  engines pick it up the next time they are prepared or reset. */
+    void setNoiseSeed (std::uint64_t seed) noexcept { noiseSeed.store (seed, std::memory_order_relaxed); }
+
+    /** Saturation latency in samples (oversampling, or ADAA's half sample
+     *  per chained waveshaper) of the active flavor in that Carbonated state.
+     *  Declared by the flavor, never measured from the audio path. */
+    float getLatencyInSamples (bool carbonated) const;
 
-    /** Get oversampling latency in samples */
-    float getLatencyInSamples() const;
+    /** Longest tail of the selected flavor and (with Blend on) the blend
+     *  flavor — from the parameters, so callable from any thread */
+    double getTailLengthSeconds (bool carbonated) const;
+
+    /** Adds every prepared engine's buffers to report, owners named
+     *  ownerPrefix + flavor name (message thread) */
+    void reportMemory (MemoryReport& report, const juce::String& ownerPrefix) const;
+
+    /** Internal control rate: Fizz-derived drive/coefficients are refreshed
+     *  every numSamples samples (16/32/64...), independent of the host buffer size. */
+    void setControlBlockSize (int numSamples);
+    int getControlBlockSize() const { return static_cast<int> (controlBlockSize); }
+
+    /** Fused kernels (default): where a flavor's saturator runs at the base
+     *  rate it is folded into the following filter cascade's loop. Off =
+     *  the stage-by-stage reference path, kept for A/B and verification. */
+    void setFusedKernels (bool shouldFuse);
+
+    /** Flavor changes cross-fade from the outgoing to the incoming engine over
+     *  this time; 0 switches instantly between blocks */
+    void setTransitionTime (double seconds);
+
+    static constexpr double kDefaultTransitionSeconds = 0.03;
+
+    /** Input an engine is run over before it's faded in. Costs one burst of
+     *  that much processing on the block the engine starts in. */
+    static constexpr double kPreRollSeconds = 0.1;
+
+    static constexpr int kDefaultControlBlockSize = 32;
+    static constexpr int kMaxControlBlockSize = FlavorEngine::kMaxControlBlockSize;
 
 private:
-    // Per-flavor process methods
-    void processCola (juce::dsp::AudioBlock<float>& block);
-    void processCherry (juce::dsp::AudioBlock<float>& block);
-    void processGrape (juce::dsp::AudioBlock<float>& block);
-    void processLemonLime (juce::dsp::AudioBlock<float>& block);
-    void processOrangeCream (juce::dsp::AudioBlock<float>& block);
-
-    // Per-flavor FLAT alternate modes
-    void processColaFlat (juce::dsp::AudioBlock<float>& block);
-    void processCherryFlat (juce::dsp::AudioBlock<float>& block);
-    void processGrapeFlat (juce::dsp::AudioBlock<float>& block);
-    void processLemonLimeFlat (juce::dsp::AudioBlock<float>& block);
-    void processOrangeCreamFlat (juce::dsp::AudioBlock<float>& block);
-
-    // ─── Shared saturation engine (oversampled) ─────────────────
-    SaturationEngine saturationEngine;
+    static constexpr int kNumFlavors = FlavorRegistry::kNumFlavors;
+
+    /** Shared by every instance: polls for requested flavors and prepares them */
+    class PreparationThread;
+
+    enum class SlotState
+    {
+        Unprepared,     // No engine, or one prepared for an old spec
+        Requested,      // Wanted by the audio thread, waiting for PreparationThread
+        Ready           // Prepared; owned by the audio thread from here on
+    };
+
+    struct Slot
+    {
+        std::unique_ptr<FlavorEngine> engine;
+        std::atomic<SlotState> state { SlotState::Unprepared };
+    };
+
+    /** Spec, smoothers and transition/blend/dual-mono state — everything
+     *  prepare() and prepareDeferred() share (under preparationLock) */
+    void prepareProcessingState (const juce::dsp::ProcessSpec& spec);
+
+    /** Builds and prepares every Requested slot (PreparationThread) */
+    void prepareRequestedFlavors();
+
+    /** Creates the flavor's engine if the slot has none (preparation threads only) */
+    FlavorEngine& createEngine (int flavor);
+
+    /** Creates the flavor's engine if needed and prepares it for preparedSpec
+     *  with the current settings (preparation threads only) */
+    void prepareEngine (int flavor);
+
+    /** Pushes the current quality settings to an engine */
+    void applySettings (FlavorEngine& engine) const;
+
+    int getSelectedFlavorIndex() const;
+
+    /** Makes a Ready engine the active one, fading from the current flavor */
+    void beginTransition (int incomingFlavor);
+
+    /** Current settings, cleared state, then the engine runs over the input
+     *  history up to the current block (see kPreRollSeconds) */
+    void warmUp (int flavor);
+
+    /** Sizes the input history for preparedSpec (never the audio thread) */
+    void allocateHistory();
+
+    /** Appends the block's input to the history */
+    void writeHistory (const juce::dsp::AudioBlock<float>& block) noexcept;
+
+    /** Engages the blend slot's engine, or requests it if it isn't ready.
+     *  Returns true while the previous blend flavor is being faded out. */
+    bool updateBlendFlavor (bool blendWanted);
+
+    /** Ready -> true; Unprepared -> asks PreparationThread for it (offline:
+     *  and waits until it's ready) */
+    bool requestFlavor (int flavor);
+
+    /** Active flavor, including an ongoing transition */
+    void processPrimary (juce::dsp::AudioBlock<float>& block);
+
+    void processFlavor (int flavor, juce::dsp::AudioBlock<float>& block, juce::SmoothedValue<float>& fizz);
+
+    /** Active, blend and transition engines over the block (after the flavor
+     *  and blend slots have been updated for it) */
+    void processEngines (juce::dsp::AudioBlock<float>& block, bool blendWanted);
+
+    /** Every channel identical to channel 0 */
+    static bool hasIdenticalChannels (const juce::dsp::AudioBlock<float>& block) noexcept;
+
+    /** Every engine that may run is channel-symmetric in the current Carbonated
+     *  state, and the channels' inputs have been identical for longer than
+     *  those engines' tails (counted up to and excluding this block) */
+    bool canProcessDualMono() const noexcept;
+
+    /** Leaving dual mono: channel 0's state to the others, then the fade */
+    void resumeStereo (size_t numChannels);
+
+    /** Calls fn (engine) for the active and blend engines */
+    template <typename Function>
+    void forEachRunningEngine (Function&& fn)
+    {
+        for (const int flavor : { activeFlavor, blendFlavor })
+            if (flavor >= 0)
+                fn (*slots[static_cast<size_t> (flavor)].engine);
+    }
+
+    // ─── Flavor engines ─────────────────────────────────────────
+    std::array<Slot, kNumFlavors> slots;
+    int activeFlavor = -1;                    // Slot being processed (audio thread)
+    juce::dsp::ProcessSpec preparedSpec {};
+    bool isPrepared = false;
+    bool renderOffline = false;               // Switches wait for PreparationThread
+    juce::CriticalSection preparationLock;    // prepare() vs PreparationThread — never the audio thread
+    juce::SharedResourcePointer<PreparationThread> preparationThread;
+
+    // ─── Flavor transition ──────────────────────────────────────
+    double transitionSeconds = kDefaultTransitionSeconds;
+    int outgoingFlavor = -1;                  // Still running while the fade lasts
+    int transitionLength = 0;
+    int transitionRemaining = 0;
+
+    // ─── Input history (pre-roll) ───────────────────────────────
+    juce::AudioBuffer<float> inputHistory;    // Ring: kPreRollSeconds plus one block
+    int preRollSamples = 0;
+    int historyWritePosition = 0;
+    int historyNumValid = 0;                  // Recorded since the last reset
+    int historyExcluded = 0;                  // Of those, the block being processed
+
+    // ─── Dual mono ──────────────────────────────────────────────
+    bool processingDualMono = false;
+    juce::int64 identicalSamples = 0;         // Run of identical input channels
+
+    // Freshly reset engines hold the same (empty) state on every channel
+    static constexpr juce::int64 kChannelsInSync = std::numeric_limits<juce::int64>::max() / 2;
+    int stereoFadeLength = 0;
+    int stereoFadeRemaining = 0;              // Channels 1+ fading in from channel 0
+
+    // ─── Blend (second flavor slot) ─────────────────────────────
+    int blendFlavor = -1;                     // Engaged blend engine
+    bool primaryIdle = false;                 // Active engine skipped at morph 1
+    bool blendIdle = false;                   // Blend engine skipped at morph 0
+    juce::SmoothedValue<float> smoothedMorph;
+
+    // ─── Settings for every engine ──────────────────────────────
+    QualityMode qualityMode = QualityMode::HighQuality;
+    int oversamplingStages = 2;
+    SaturationEngine::OversamplingFilter oversamplingFilter = SaturationEngine::OversamplingFilter::MinimumPhaseIIR;
+    bool exactNonlinearities = false;
+    bool useFusedKernels = true;
+    std::atomic<std::uint64_t> noiseSeed { FlavorEngine::kDefaultNoiseSeed };
 
     // ─── Shared state ───────────────────────────────────────────
+    ScratchArena& scratch;
     juce::AudioParameterChoice* flavorTypeParam;
+    juce::AudioParameterBool* blendParam;
+    juce::AudioParameterChoice* blendFlavorParam;
+    juce::AudioParameterFloat* blendMorphParam;
     juce::SmoothedValue<float> smoothedFizz;
+    size_t controlBlockSize = kDefaultControlBlockSize;
     bool carbonatedState = true;
-    double sampleRate = 44100.0;
-    int numChannels = 2;
-    int blockSize = 512;
-
-    // ─── COLA DSP members ───────────────────────────────────────
-    juce::dsp::Compressor<float> colaCompressor;
-    juce::dsp::StateVariableTPTFilter<float> colaDCBlocker;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
-                                   juce::dsp::IIR::Coefficients<float>> colaLowShelf;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
-                                   juce::dsp::IIR::Coefficients<float>> colaHighShelf;
-
-    // ─── CHERRY DSP members ─────────────────────────────────────
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
-                                   juce::dsp::IIR::Coefficients<float>> cherryDeHarsh;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
-                                   juce::dsp::IIR::Coefficients<float>> cherryPresence;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
-                                   juce::dsp::IIR::Coefficients<float>> cherryAirShelf;
-    // FLAT: chorus
-    float cherryChorusPhase = 0.0f;
-    juce::AudioBuffer<float> cherryChorusDelayBuffer;
-    int cherryChorusWritePos = 0;
-
-    // ─── GRAPE DSP members ──────────────────────────────────────
-    juce::dsp::StateVariableTPTFilter<float> grapeDCBlocker;
-    juce::dsp::StateVariableTPTFilter<float> grapeTapeLP;
-    juce::AudioBuffer<float> grapeDelayBuffer;
-    int grapeDelayWritePos = 0;
-    float grapeWowPhase = 0.0f;
-    float grapeFlutterPhase = 0.0f;
-    juce::Random grapeNoiseRNG;
-    // FLAT: vinyl rumble
-    juce::dsp::StateVariableTPTFilter<float> grapeVinylRumbleLP;
-
-    // ─── LEMON-LIME DSP members ─────────────────────────────────
-    // True Linkwitz-Riley 4th-order (cascaded 2nd-order SVTPF)
-    juce::dsp::StateVariableTPTFilter<float> lemonLowPass1;
-    juce::dsp::StateVariableTPTFilter<float> lemonLowPass2;
-    juce::dsp::StateVariableTPTFilter<float> lemonHighPass1;
-    juce::dsp::StateVariableTPTFilter<float> lemonHighPass2;
-    juce::AudioBuffer<float> lemonLowBandBuffer;
-    juce::dsp::Compressor<float> lemonHFCompressor;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
-                                   juce::dsp::IIR::Coefficients<float>> lemonPresence;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
-                                   juce::dsp::IIR::Coefficients<float>> lemonAirShelf;
-    // FLAT: telephone EQ
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
-                                   juce::dsp::IIR::Coefficients<float>> lemonTeleBandpass;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
-                                   juce::dsp::IIR::Coefficients<float>> lemonTeleHighCut;
-
-    // ─── ORANGE CREAM DSP members (Lowpass Filter + Drive) ──────
-    juce::dsp::StateVariableTPTFilter<float> orangeLP1;   // Resonant LPF stage 1
-    juce::dsp::StateVariableTPTFilter<float> orangeLP2;   // Steep LPF stage 2
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
-                                   juce::dsp::IIR::Coefficients<float>> orangeLowShelf;
 };
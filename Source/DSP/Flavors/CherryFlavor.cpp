@@ -0,0 +1,119 @@
+#include "CherryFlavor.h"
+#include "DSP/FizzCurves.h"
+#include <cmath>
+
+// FLAT chorus: base delay plus the Fizz-mapped depth range
+static constexpr float kChorusBaseDelayMs = 3.0f;
+static constexpr float kChorusMinDepthMs = 0.5f;
+static constexpr float kChorusMaxDepthMs = 1.0f;
+
+void CherryFlavor::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    prepareEngine (spec);
+    buildMorphTable();
+
+    eq.prepare (subBlockSpec, 3, *scratch);
+    const double maxDelayMs = kChorusBaseDelayMs + kChorusMaxDepthMs;
+    chorusDelay.prepare (numChannels, static_cast<int> (std::ceil (maxDelayMs * 0.001 * sampleRate)));
+    chorusLFO.prepare (ModulationLFO::Shape::Sine, sampleRate, 1.5);   // 1.5Hz rate
+    chorusBaseDelaySamples = static_cast<float> (kChorusBaseDelayMs * 0.001 * sampleRate);
+}
+
+void CherryFlavor::reset()
+{
+    saturationEngine.reset();
+    eq.reset();
+    chorusDelay.reset();
+    chorusLFO.reset();
+}
+
+void CherryFlavor::reportMemory (MemoryReport& report, const juce::String& owner) const
+{
+    report.add (owner, "engine object", sizeof (CherryFlavor));
+    FlavorEngine::reportMemory (report, owner);
+    report.add (owner, "morph table", morph.getMemoryBytes());
+    report.add (owner, "chorus delay", chorusDelay.getMemoryBytes());
+}
+
+void CherryFlavor::copyChannelState (size_t source, size_t dest) noexcept
+{
+    FlavorEngine::copyChannelState (source, dest);
+    eq.copyChannelState (source, dest);
+    chorusDelay.copyChannelState (source, dest);
+}
+
+void CherryFlavor::buildMorphTable()
+{
+    using Type = BiquadDesign::Type;
+    const double sr = sampleRate;
+    auto msToSamples = [sr] (float ms) { return static_cast<float> (ms * 0.001 * sr); };
+
+    morph.build ([sr, msToSamples] (float fizz)
+    {
+        Controls c {};
+        c.blend    = FizzCurves::sCurve (fizz, 0.10f, 0.65f);
+        c.drive    = FizzCurves::exponential (fizz, 1.5f, 4.5f, 2.5f);
+        c.driveInv = 1.0f / c.drive;
+        c.chorusDepthSamples = msToSamples (FizzCurves::sCurve (fizz, kChorusMinDepthMs, kChorusMaxDepthMs));   // FLAT chorus
+        BiquadDesign::design (Type::Peak, sr, 3500.0f, 2.0f,
+                              FizzCurves::logarithmic (fizz, 0.0f, -4.0f, 1.8f), c.deHarsh);
+        BiquadDesign::design (Type::Peak, sr, 4500.0f, 1.5f,
+                              FizzCurves::logarithmic (fizz, 0.0f, 6.0f, 1.8f), c.presence);
+        BiquadDesign::design (Type::HighShelf, sr, 12000.0f, 0.707f,
+                              FizzCurves::logarithmic (fizz, 0.0f, 4.0f, 1.8f), c.airShelf);
+        return c;
+    });
+}
+
+double CherryFlavor::getTailLengthSeconds (bool carbonated) noexcept
+{
+    // De-harsh notch (3.5kHz, Q 2), plus the longest chorus delay in FLAT
+    const double eqTail = getDecaySeconds (3500.0, 2.0);
+    return carbonated ? eqTail : eqTail + (kChorusBaseDelayMs + kChorusMaxDepthMs) * 0.001;
+}
+
+template <bool carbonated>
+void CherryFlavor::process (juce::dsp::AudioBlock<float>& block, juce::SmoothedValue<float>& fizz, size_t controlBlockSize)
+{
+    forEachControlBlock (block, fizz, controlBlockSize, [this] (juce::dsp::AudioBlock<float>& subBlock, float controlFizz)
+    {
+        const auto controls = morph.lookup (controlFizz);
+
+        processCarbonated (subBlock, controls);
+
+        if constexpr (! carbonated)
+            processChorus (subBlock, controls);
+    });
+}
+
+template void CherryFlavor::process<true> (juce::dsp::AudioBlock<float>&, juce::SmoothedValue<float>&, size_t);
+template void CherryFlavor::process<false> (juce::dsp::AudioBlock<float>&, juce::SmoothedValue<float>&, size_t);
+
+void CherryFlavor::processCarbonated (juce::dsp::AudioBlock<float>& block, const Controls& controls)
+{
+    // Oversampled parallel saturation via SaturationEngine (mix handles parallel blend)
+    SaturationEngine::Params satParams;
+    satParams.curve = SaturationEngine::CurveType::Tanh;
+    satParams.drive = controls.drive;
+    satParams.outputGain = controls.driveInv;  // Normalize: tanh(x*d)/d
+    satParams.mix = controls.blend;
+
+    // De-harsh notch @ 3.5kHz -> presence bell @ 4.5kHz -> air shelf @ 12kHz, one pass
+    eq.setBiquad (0, controls.deHarsh);
+    eq.setBiquad (1, controls.presence);
+    eq.setBiquad (2, controls.airShelf);
+    saturateAndFilter (block, satParams, eq);
+}
+
+void CherryFlavor::processChorus (juce::dsp::AudioBlock<float>& block, const Controls& controls)
+{
+    // FLAT: subtle chorus (1.5Hz rate, 0.5-1ms depth)
+    const auto nSamples = block.getNumSamples();
+    const float chorusMix = 0.3f;
+
+    auto* delaySamples = scratch->allocate (nSamples);   // Per-sample delay
+    juce::FloatVectorOperations::fill (delaySamples, chorusBaseDelaySamples, static_cast<int> (nSamples));
+    chorusLFO.addTo (delaySamples, nSamples, controls.chorusDepthSamples);
+
+    chorusDelay.process (block, delaySamples, chorusMix);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "FlavorEngine.h"
+#include "DSP/ModulatedDelayLine.h"
+#include "DSP/ModulationLFO.h"
+
+/**
+ * CHERRY — Sweet Vocal Presence
+ * Parallel tanh saturation -> de-harsh notch -> presence bell -> air shelf.
+ * FLAT adds a subtle chorus.
+ */
+class CherryFlavor final : public FlavorEngine
+{
+public:
+    void prepare (const juce::dsp::ProcessSpec& spec) override;
+    void reset() override;
+    void reportMemory (MemoryReport& report, const juce::String& owner) const override;
+    void copyChannelState (size_t source, size_t dest) noexcept override;
+
+    /** Time the output takes to decay to silence once the input stops */
+    static double getTailLengthSeconds (bool carbonated) noexcept;
+
+    /** Runs a host block at control rate, Fizz taken from the smoother */
+    template <bool carbonated>
+    void process (juce::dsp::AudioBlock<float>& block, juce::SmoothedValue<float>& fizz, size_t controlBlockSize);
+
+private:
+    struct Controls
+    {
+        float blend, drive, driveInv, chorusDepthSamples;
+        float deHarsh[kNumCoeffs], presence[kNumCoeffs], airShelf[kNumCoeffs];
+    };
+
+    void buildMorphTable();
+
+    void processCarbonated (juce::dsp::AudioBlock<float>& block, const Controls& controls);
+
+    /** FLAT: chorus, run after the carbonated chain */
+    void processChorus (juce::dsp::AudioBlock<float>& block, const Controls& controls);
+
+    FizzMorphTable<Controls> morph;
+
+    FilterCascade eq;                 // De-harsh notch + presence bell + air shelf
+    // FLAT: chorus
+    ModulatedDelayLine chorusDelay;
+    ModulationLFO chorusLFO;
+    float chorusBaseDelaySamples = 0.0f;
+};
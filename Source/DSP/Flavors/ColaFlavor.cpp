@@ -0,0 +1,145 @@
+#include "ColaFlavor.h"
+#include "DSP/FizzCurves.h"
+
+void ColaFlavor::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    prepareEngine (spec);
+    buildMorphTable();
+
+    compressor.prepare (spec);
+    compressor.setAttack (10.0f);
+    compressor.setRelease (100.0f);
+    compRatio = 0.0f;
+    compThresh = 0.0f;
+    dcBlocker.prepare (subBlockSpec, 1, *scratch);
+    dcBlocker.setSVF (0, FilterCascade::SVFType::HighPass, 5.0f);
+    tiltEQ.prepare (subBlockSpec, 2, *scratch);
+}
+
+void ColaFlavor::reset()
+{
+    saturationEngine.reset();
+    compressor.reset();
+    dcBlocker.reset();
+    tiltEQ.reset();
+}
+
+void ColaFlavor::reportMemory (MemoryReport& report, const juce::String& owner) const
+{
+    report.add (owner, "engine object", sizeof (ColaFlavor));
+    FlavorEngine::reportMemory (report, owner);
+    report.add (owner, "morph table", morph.getMemoryBytes());
+}
+
+void ColaFlavor::copyChannelState (size_t source, size_t dest) noexcept
+{
+    // The compressor's envelope is internal to juce::dsp::Compressor: it
+    // catches up within its attack/release
+    FlavorEngine::copyChannelState (source, dest);
+    dcBlocker.copyChannelState (source, dest);
+    tiltEQ.copyChannelState (source, dest);
+}
+
+void ColaFlavor::buildMorphTable()
+{
+    using Type = BiquadDesign::Type;
+    const double sr = sampleRate;
+
+    morph.build ([sr] (float fizz)
+    {
+        Controls c {};
+        c.drive      = FizzCurves::exponential (fizz, 1.0f, 4.0f, 2.5f);
+        c.compRatio  = FizzCurves::exponential (fizz, 1.5f, 6.0f, 2.0f);
+        c.compThresh = FizzCurves::linear (fizz, -6.0f, -30.0f);
+        c.tapeDrive  = FizzCurves::exponential (fizz, 1.0f, 3.0f, 2.0f);     // FLAT tape layer
+        c.tapeDriveInv = 1.0f / c.tapeDrive;
+        BiquadDesign::design (Type::LowShelf, sr, 200.0f, 0.707f,
+                              FizzCurves::logarithmic (fizz, 0.0f, 3.5f, 1.8f), c.lowShelf);
+        BiquadDesign::design (Type::HighShelf, sr, 8000.0f, 0.707f,
+                              FizzCurves::logarithmic (fizz, 0.0f, -3.0f, 1.8f), c.highShelf);
+        return c;
+    });
+}
+
+double ColaFlavor::getTailLengthSeconds (bool /*carbonated*/) noexcept
+{
+    // The 5Hz DC blocker (Butterworth SVF, Q 0.707) rings longest, in both modes
+    return getDecaySeconds (5.0, 0.707);
+}
+
+template <bool carbonated>
+void ColaFlavor::process (juce::dsp::AudioBlock<float>& block, juce::SmoothedValue<float>& fizz, size_t controlBlockSize)
+{
+    forEachControlBlock (block, fizz, controlBlockSize, [this] (juce::dsp::AudioBlock<float>& subBlock, float controlFizz)
+    {
+        const auto controls = morph.lookup (controlFizz);
+
+        if constexpr (carbonated)
+            processCarbonated (subBlock, controls);
+        else
+            processFlat (subBlock, controls);
+    });
+}
+
+template void ColaFlavor::process<true> (juce::dsp::AudioBlock<float>&, juce::SmoothedValue<float>&, size_t);
+template void ColaFlavor::process<false> (juce::dsp::AudioBlock<float>&, juce::SmoothedValue<float>&, size_t);
+
+void ColaFlavor::processCarbonated (juce::dsp::AudioBlock<float>& block, const Controls& controls)
+{
+    // Oversampled asymmetric soft clip via SaturationEngine
+    SaturationEngine::Params satParams;
+    satParams.curve = SaturationEngine::CurveType::AsymSoftClip;
+    satParams.drive = controls.drive;
+    satParams.dcBias = 0.1f;
+
+    // + DC Blocker (HPF @ 5Hz)
+    saturateAndFilter (block, satParams, dcBlocker);
+
+    processConsole (block, controls);
+}
+
+void ColaFlavor::processFlat (juce::dsp::AudioBlock<float>& block, const Controls& controls)
+{
+    // FLAT: extra tape saturation layer, chained straight after the console
+    // clip inside the same oversampled region — one up/down pair for both
+    // stages, and the tape stage no longer aliases at 1x
+    SaturationEngine::Stage chain[getSaturationStages (false)];
+
+    // 1. Asymmetric console clip, its DC offset removed before the tape stage
+    chain[0].shaper.curve = SaturationEngine::CurveType::AsymSoftClip;
+    chain[0].shaper.drive = controls.drive;
+    chain[0].shaper.dcBias = 0.1f;
+    chain[0].filter.type = SaturationEngine::ChainFilter::Type::DCBlock;
+    chain[0].filter.frequency = 5.0f;
+
+    // 2. Tape: tanh(x*d)/d
+    chain[1].shaper.curve = SaturationEngine::CurveType::Tanh;
+    chain[1].shaper.drive = controls.tapeDrive;
+    chain[1].shaper.outputGain = controls.tapeDriveInv;
+
+    saturationEngine.processChain (block, chain);
+
+    // DC Blocker (HPF @ 5Hz)
+    dcBlocker.process (block);
+
+    processConsole (block, controls);
+}
+
+void ColaFlavor::processConsole (juce::dsp::AudioBlock<float>& block, const Controls& controls)
+{
+    // Compressor (fixed attack/release set in prepare)
+    if (controls.compRatio != compRatio)
+        compressor.setRatio (compRatio = controls.compRatio);
+    if (controls.compThresh != compThresh)
+        compressor.setThreshold (compThresh = controls.compThresh);
+    {
+        juce::dsp::ProcessContextReplacing<float> ctx (block);
+        compressor.process (ctx);
+    }
+
+    // Tilt EQ: low shelf + high shelf, one pass
+    tiltEQ.setBiquad (0, controls.lowShelf);
+    tiltEQ.setBiquad (1, controls.highShelf);
+    tiltEQ.process (block);
+    // No static makeup gain — auto-gain compensation handles this in EffectsChain
+}
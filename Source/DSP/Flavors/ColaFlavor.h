@@ -0,0 +1,50 @@
+#pragma once
+
+#include "FlavorEngine.h"
+
+/**
+ * COLA — Analog Console Warmth
+ * Asymmetric soft clip -> DC blocker -> glue compressor -> tilt EQ.
+ * FLAT adds a tape saturation stage inside the same oversampled region.
+ */
+class ColaFlavor final : public FlavorEngine
+{
+public:
+    void prepare (const juce::dsp::ProcessSpec& spec) override;
+    void reset() override;
+    void reportMemory (MemoryReport& report, const juce::String& owner) const override;
+    void copyChannelState (size_t source, size_t dest) noexcept override;
+
+    /** Time the output takes to decay to silence once the input stops */
+    static double getTailLengthSeconds (bool carbonated) noexcept;
+
+    /** FLAT chains a tape stage after the console clip */
+    static constexpr int getSaturationStages (bool carbonated) noexcept { return carbonated ? 1 : 2; }
+
+    /** Runs a host block at control rate, Fizz taken from the smoother */
+    template <bool carbonated>
+    void process (juce::dsp::AudioBlock<float>& block, juce::SmoothedValue<float>& fizz, size_t controlBlockSize);
+
+private:
+    struct Controls
+    {
+        float drive, compRatio, compThresh, tapeDrive, tapeDriveInv;
+        float lowShelf[kNumCoeffs], highShelf[kNumCoeffs];
+    };
+
+    void buildMorphTable();
+
+    void processCarbonated (juce::dsp::AudioBlock<float>& block, const Controls& controls);
+    void processFlat (juce::dsp::AudioBlock<float>& block, const Controls& controls);
+
+    /** Post-saturation section (glue compressor, tilt EQ) */
+    void processConsole (juce::dsp::AudioBlock<float>& block, const Controls& controls);
+
+    FizzMorphTable<Controls> morph;
+
+    juce::dsp::Compressor<float> compressor;
+    float compRatio = 0.0f;       // Last values pushed to the compressor
+    float compThresh = 0.0f;
+    FilterCascade dcBlocker;      // SVF HP @ 5Hz
+    FilterCascade tiltEQ;         // Low shelf + high shelf
+};
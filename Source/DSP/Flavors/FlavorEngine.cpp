@@ -0,0 +1,118 @@
+#include "FlavorEngine.h"
+#include <cmath>
+
+void FlavorEngine::setQualityMode (QualityMode mode)
+{
+    switch (mode)
+    {
+        case QualityMode::Standard:    saturationEngine.setAntiAliasing (SaturationEngine::AntiAliasing::None); break;
+        case QualityMode::HighQuality: saturationEngine.setAntiAliasing (SaturationEngine::AntiAliasing::Oversampling); break;
+        case QualityMode::ADAA:        saturationEngine.setAntiAliasing (SaturationEngine::AntiAliasing::Antiderivative); break;
+        // The whole processor already runs oversampled (see EffectsChain)
+        case QualityMode::OversampledChain: saturationEngine.setAntiAliasing (SaturationEngine::AntiAliasing::None); break;
+    }
+}
+
+void FlavorEngine::setOversampling (int numStages, SaturationEngine::OversamplingFilter filter)
+{
+    saturationEngine.setOversampling (numStages, filter);
+}
+
+void FlavorEngine::setExactNonlinearities (bool shouldBeExact)
+{
+    saturationEngine.setExactTanh (shouldBeExact);
+}
+
+void FlavorEngine::reportMemory (MemoryReport& report, const juce::String& owner) const
+{
+    report.add (owner, "saturation engine", saturationEngine.getMemoryBytes());
+}
+
+void FlavorEngine::copyChannelState (size_t source, size_t dest) noexcept
+{
+    saturationEngine.copyChannelState (source, dest);
+}
+
+size_t FlavorEngine::getScratchBytes (const juce::dsp::ProcessSpec& spec) noexcept
+{
+    auto sub = spec;
+    sub.maximumBlockSize = juce::jmin (spec.maximumBlockSize, static_cast<juce::uint32> (kMaxControlBlockSize));
+    const auto numSamples = static_cast<size_t> (sub.maximumBlockSize);
+
+    return ScratchArena::getBlockBytes (sub.numChannels, numSamples)
+         + 2 * ScratchArena::getBlockBytes (1, numSamples)
+         + FilterCascade::getScratchBytes (sub);
+}
+
+double FlavorEngine::getDecaySeconds (double frequency, double q) noexcept
+{
+    // Envelope exp (-pi * f * t / Q), solved for kTailDecayDb of attenuation
+    const double nepers = kTailDecayDb / 20.0 * std::log (10.0);
+    return nepers * q / (juce::MathConstants<double>::pi * frequency);
+}
+
+void FlavorEngine::prepareEngine (const juce::dsp::ProcessSpec& spec)
+{
+    ScratchArena::assertNotOnAudioThread();
+    jassert (scratch != nullptr);
+
+    sampleRate = spec.sampleRate;
+    numChannels = static_cast<int> (spec.numChannels);
+
+    subBlockSpec = spec;
+    subBlockSpec.maximumBlockSize = juce::jmin (spec.maximumBlockSize,
+                                                static_cast<juce::uint32> (kMaxControlBlockSize));
+    saturationEngine.prepare (subBlockSpec);
+}
+
+// =============================================================================
+// Fused saturator + filter cascade
+// =============================================================================
+void FlavorEngine::saturateAndFilter (juce::dsp::AudioBlock<float>& block,
+                                      const SaturationEngine::Params& params,
+                                      FilterCascade& cascade)
+{
+    // Oversampled or ADAA saturation needs whole blocks / its own state:
+    // reference path, stage by stage
+    if (! useFusedKernels || saturationEngine.getAntiAliasing() != SaturationEngine::AntiAliasing::None)
+    {
+        saturationEngine.process (block, params);
+        cascade.process (block);
+        return;
+    }
+
+    using Curve = SaturationEngine::CurveType;
+    const bool exact = saturationEngine.isExactTanh();
+
+    switch (params.curve)
+    {
+        case Curve::SoftClip:     saturateAndFilterFused<Curve::SoftClip, false> (block, params, cascade); break;
+        case Curve::AsymSoftClip: saturateAndFilterFused<Curve::AsymSoftClip, false> (block, params, cascade); break;
+        case Curve::WarmClip:     saturateAndFilterFused<Curve::WarmClip, false> (block, params, cascade); break;
+        case Curve::Tanh:
+            if (exact)
+                saturateAndFilterFused<Curve::Tanh, true> (block, params, cascade);
+            else
+                saturateAndFilterFused<Curve::Tanh, false> (block, params, cascade);
+            break;
+    }
+}
+
+template <SaturationEngine::CurveType curve, bool exactTanh>
+void FlavorEngine::saturateAndFilterFused (juce::dsp::AudioBlock<float>& block,
+                                           const SaturationEngine::Params& params,
+                                           FilterCascade& cascade) noexcept
+{
+    const float drive = params.drive;
+    const float bias = params.dcBias;
+    const float offset = SaturationEngine::shapeSample<curve, exactTanh> (bias);
+    const float gain = params.outputGain;
+    const float mix = params.mix < 0.999f ? params.mix : 1.0f;   // Same cut-off as the engine
+
+    // Same per-sample maths as SaturationEngine's base-rate kernels
+    cascade.process (block, [=] (float in) noexcept
+    {
+        const float out = (SaturationEngine::shapeSample<curve, exactTanh> (in * drive + bias) - offset) * gain;
+        return in + mix * (out - in);
+    });
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "Parameters/ParameterIDs.h"
+#include "DSP/SaturationEngine.h"
+#include "DSP/FilterCascade.h"
+#include "DSP/ScratchArena.h"
+#include "DSP/FizzMorphTable.h"
+#include "DSP/MemoryReport.h"
+
+/**
+ * Common base of the per-flavor engines (ColaFlavor, CherryFlavor...).
+ * Each flavor is its own type owning its SaturationEngine, filters, Fizz
+ * morph table(s) and state. This base holds what they share: the quality
+ * settings, the fused saturate + filter helper and the control-rate loop.
+ * Flavors expose template <bool carbonated> process(), explicitly instantiated
+ * in the flavor's .cpp — every flavor/Carbonated combination is a separate
+ * compiled loop with the whole chain visible to the optimiser and no flavor
+ * or carbonation branches inside it. Only prepare/reset (and the memory
+ * report) are virtual; the engines are created and driven through FlavorRegistry.
+ * Temporary buffers come from the owner's ScratchArena, released after every
+ * control block; engines own only their state.
+ */
+class FlavorEngine
+{
+public:
+    virtual ~FlavorEngine() = default;
+
+    /** Allocates and resets everything the flavor needs at this spec */
+    virtual void prepare (const juce::dsp::ProcessSpec& spec) = 0;
+    virtual void reset() = 0;
+
+    /** Adds the engine's heap buffers to report under owner (message thread) */
+    virtual void reportMemory (MemoryReport& report, const juce::String& owner) const;
+
+    /** Channel dest's state becomes a copy of channel source's, so a channel
+     *  that sat out while carrying the same signal (see FlavorProcessor's
+     *  dual-mono path) resumes seamlessly. Audio thread safe. */
+    virtual void copyChannelState (size_t source, size_t dest) noexcept;
+
+    /** True when identical input channels always give identical output
+     *  channels — nothing per-channel random, nothing mixing channels.
+     *  Flavors for which that's not so hide this with their own. */
+    static bool isChannelSymmetric (bool /*carbonated*/) noexcept { return true; }
+
+    /** Select the saturation anti-aliasing mode (Standard / HQ / ADAA) */
+    void setQualityMode (QualityMode mode);
+
+    /** HQ oversampling factor (numStages 1-4 = 2x-16x) and half-band design */
+    void setOversampling (int numStages, SaturationEngine::OversamplingFilter filter);
+
+    /** See SaturationEngine::buildRequestedOversampler() */
+    void buildRequestedOversampler() { saturationEngine.buildRequestedOversampler(); }
+
+    /** See SaturationEngine::updateOversampler() */
+    bool updateOversampler() noexcept { return saturationEngine.updateOversampler(); }
+
+    /** Exact (libm) nonlinearities instead of the fast approximations */
+    void setExactNonlinearities (bool shouldBeExact);
+
+    /** See FlavorProcessor::setFusedKernels() */
+    void setFusedKernels (bool shouldFuse) { useFusedKernels = shouldFuse; }
+
+    /** Seed of the flavor's noise sources, if it has any — they restart from
+     *  it on every prepare() and reset() */
+    virtual void setNoiseSeed (std::uint64_t /*seed*/) noexcept {}
+
+    /** The seed every instance used before seeds were per instance (and
+     *  sessions saved then still get) */
+    static constexpr std::uint64_t kDefaultNoiseSeed = 0x47524150450a0001ull;
+
+    /** Arena the engine's stages take their temporary buffers from. Set before prepare(). */
+    void setScratchArena (ScratchArena& arena) noexcept { scratch = &arena; }
+
+    /** Scratch any flavor needs at once while processing blocks of spec — one
+     *  full-width sub-block (e.g. Lemon-Lime's low band), two single-channel
+     *  ones (e.g. Grape's delay curve and rumble) and a filter cascade's frames */
+    static size_t getScratchBytes (const juce::dsp::ProcessSpec& spec) noexcept;
+
+    /** Waveshapers the flavor chains in one saturation pass in each Carbonated
+     *  state — in ADAA mode each adds SaturationEngine::kADAALatency. Flavors
+     *  that chain more hide this with their own. */
+    static constexpr int getSaturationStages (bool /*carbonated*/) noexcept { return 1; }
+
+    /** Saturation latency with saturationStages chained waveshapers (the
+     *  flavor's getSaturationStages() for the Carbonated state in use) */
+    float getLatencyInSamples (int saturationStages) const
+    {
+        return saturationEngine.getLatencyInSamples (static_cast<size_t> (saturationStages));
+    }
+
+    /** Level, relative to full scale, a flavor's tail must have decayed by
+     *  before its output counts as silent (see EffectsChain's silence detection) */
+    static constexpr double kTailDecayDb = 120.0;
+
+    /** Seconds a resonance at frequency with quality factor q (0.5 for a
+     *  first-order section) takes to ring down by kTailDecayDb — what each
+     *  flavor's static getTailLengthSeconds (carbonated) is built from */
+    static double getDecaySeconds (double frequency, double q = 0.5) noexcept;
+
+    /** Largest control-rate sub-block a flavor is ever fed */
+    static constexpr int kMaxControlBlockSize = 256;
+
+protected:
+    FlavorEngine() = default;
+
+    static constexpr int kNumCoeffs = BiquadDesign::numCoefficients;
+
+    /** Stores the spec and prepares the saturation engine. The saturator and
+     *  filter cascades are only ever fed control-rate sub-blocks, so their
+     *  buffers (up to 16x oversampled for the saturator) are sized for one
+     *  sub-block (subBlockSpec), not the host block. */
+    void prepareEngine (const juce::dsp::ProcessSpec& spec);
+
+    /** Control-rate loop: the host block is split into sub-blocks of
+     *  controlBlockSize samples, Fizz is read from the smoother for each one,
+     *  and processControlBlock (subBlock, fizz) runs every stage of the flavor
+     *  over the same cache-resident samples before moving on. Scratch taken
+     *  during a sub-block is released at its end. */
+    template <typename ControlBlockFunction>
+    void forEachControlBlock (juce::dsp::AudioBlock<float>& block, juce::SmoothedValue<float>& fizz,
+                              size_t controlBlockSize, ControlBlockFunction&& processControlBlock)
+    {
+        const auto nSamples = block.getNumSamples();
+
+        for (size_t offset = 0; offset < nSamples; offset += controlBlockSize)
+        {
+            const auto numThisTime = juce::jmin (controlBlockSize, nSamples - offset);
+            auto subBlock = block.getSubBlock (offset, numThisTime);
+
+            const float controlFizz = fizz.getCurrentValue();
+            fizz.skip (static_cast<int> (numThisTime));
+
+            const ScratchArena::Scope scope (*scratch);
+            processControlBlock (subBlock, controlFizz);
+        }
+    }
+
+    /** saturationEngine.process() followed by cascade.process() — as a single
+     *  fused loop when the saturator runs at the base rate (AntiAliasing::None,
+     *  which includes the HQ Chain instance), stage by stage otherwise. */
+    void saturateAndFilter (juce::dsp::AudioBlock<float>& block, const SaturationEngine::Params& params,
+                            FilterCascade& cascade);
+
+    SaturationEngine saturationEngine;
+    ScratchArena* scratch = nullptr;
+    juce::dsp::ProcessSpec subBlockSpec {};
+    double sampleRate = 44100.0;
+    int numChannels = 2;
+
+private:
+    template <SaturationEngine::CurveType curve, bool exactTanh>
+    static void saturateAndFilterFused (juce::dsp::AudioBlock<float>& block, const SaturationEngine::Params& params,
+                                        FilterCascade& cascade) noexcept;
+
+    bool useFusedKernels = true;
+};
@@ -0,0 +1,43 @@
+#include "FlavorRegistry.h"
+#include "ColaFlavor.h"
+#include "CherryFlavor.h"
+#include "GrapeFlavor.h"
+#include "LemonLimeFlavor.h"
+#include "OrangeCreamFlavor.h"
+
+namespace
+{
+    template <typename Flavor, bool carbonated>
+    void processFlavor (FlavorEngine& engine, juce::dsp::AudioBlock<float>& block,
+                        juce::SmoothedValue<float>& fizz, size_t controlBlockSize)
+    {
+        static_cast<Flavor&> (engine).template process<carbonated> (block, fizz, controlBlockSize);
+    }
+
+    template <typename Flavor>
+    FlavorRegistry::Descriptor makeDescriptor (FlavorType type, const char* name)
+    {
+        return { type, name,
+                 [] () -> std::unique_ptr<FlavorEngine> { return std::make_unique<Flavor>(); },
+                 { &processFlavor<Flavor, false>, &processFlavor<Flavor, true> },
+                 &Flavor::getTailLengthSeconds,
+                 &Flavor::isChannelSymmetric,
+                 &Flavor::getSaturationStages };
+    }
+}
+
+const std::array<FlavorRegistry::Descriptor, FlavorRegistry::kNumFlavors>& FlavorRegistry::getDescriptors()
+{
+    static_assert (static_cast<int> (FlavorType::OrangeCream) == kNumFlavors - 1, "Every FlavorType needs an entry");
+
+    static const std::array<Descriptor, kNumFlavors> descriptors
+    {{
+        makeDescriptor<ColaFlavor>        (FlavorType::Cola,        "Cola"),
+        makeDescriptor<CherryFlavor>      (FlavorType::Cherry,      "Cherry"),
+        makeDescriptor<GrapeFlavor>       (FlavorType::Grape,       "Grape"),
+        makeDescriptor<LemonLimeFlavor>   (FlavorType::LemonLime,   "Lemon-Lime"),
+        makeDescriptor<OrangeCreamFlavor> (FlavorType::OrangeCream, "Orange Cream")
+    }};
+
+    return descriptors;
+}
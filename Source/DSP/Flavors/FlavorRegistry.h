@@ -0,0 +1,35 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include "FlavorEngine.h"
+
+/**
+ * Registry of the flavor engines, indexed by FlavorType.
+ * Each entry is a factory plus the flavor's two compiled process loops
+ * (FLAT / Carbonated), its tail length and its saturation stage count.
+ * FlavorProcessor only goes through this table, so
+ * adding a flavor means writing its engine and adding one entry in
+ * FlavorRegistry.cpp.
+ */
+namespace FlavorRegistry
+{
+    using ProcessFunction = void (*) (FlavorEngine& engine, juce::dsp::AudioBlock<float>& block,
+                                      juce::SmoothedValue<float>& fizz, size_t controlBlockSize);
+
+    struct Descriptor
+    {
+        FlavorType type;
+        const char* name;
+        std::unique_ptr<FlavorEngine> (*create)();
+        ProcessFunction process[2];     // [carbonated]
+        double (*getTailLengthSeconds) (bool carbonated);   // Infinite if it never decays
+        bool (*isChannelSymmetric) (bool carbonated);        // Dual-mono path allowed
+        int (*getSaturationStages) (bool carbonated);        // Chained waveshapers (ADAA latency)
+    };
+
+    static constexpr int kNumFlavors = 5;
+
+    /** All flavors, in FlavorType order */
+    const std::array<Descriptor, kNumFlavors>& getDescriptors();
+}
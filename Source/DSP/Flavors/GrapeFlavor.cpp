@@ -0,0 +1,184 @@
+#include "GrapeFlavor.h"
+#include "DSP/FizzCurves.h"
+#include <cmath>
+#include <limits>
+
+// Wow & flutter delay: base delay plus the deepest modulation the Fizz map reaches
+static constexpr float kBaseDelayMs = 5.0f;
+static constexpr float kMaxWowDepthMs = 3.0f;
+static constexpr float kMaxFlutterDepthMs = 0.5f;
+
+// Vinyl layer
+static constexpr float kRumbleCutoff = 40.0f;
+
+void GrapeFlavor::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    prepareEngine (spec);
+    buildMorphTable();
+
+    dcBlocker.prepare (subBlockSpec, 1, *scratch);
+    dcBlocker.setSVF (0, FilterCascade::SVFType::HighPass, 5.0f);
+    tapeLP.prepare (subBlockSpec, 1, *scratch);
+    const double maxDelayMs = kBaseDelayMs + kMaxWowDepthMs + kMaxFlutterDepthMs;
+    wowFlutterDelay.prepare (numChannels, static_cast<int> (std::ceil (maxDelayMs * 0.001 * sampleRate)));
+    wowLFO.prepare (ModulationLFO::Shape::Sine, sampleRate, 0.4);
+    flutterLFO.prepare (ModulationLFO::Shape::Triangle, sampleRate, 4.5);
+    baseDelaySamples = static_cast<float> (kBaseDelayMs * 0.001 * sampleRate);
+
+    // Rumble is mechanical, so one (mono) signal feeds every channel
+    auto monoSpec = subBlockSpec;
+    monoSpec.numChannels = 1;
+    vinylRumbleLP.prepare (monoSpec, 1, *scratch);
+    vinylRumbleLP.setSVF (0, FilterCascade::SVFType::LowPass, kRumbleCutoff);
+
+    // Butterworth LP noise bandwidth ~1.11 * fc out of the white noise's fs / 2
+    rumbleMakeup = static_cast<float> (std::sqrt (0.5 * sampleRate / (1.11 * kRumbleCutoff)));
+
+    crackle.resize (static_cast<size_t> (numChannels));
+    seedNoise();
+}
+
+void GrapeFlavor::reset()
+{
+    saturationEngine.reset();
+    dcBlocker.reset();
+    tapeLP.reset();
+    wowFlutterDelay.reset();
+    wowLFO.reset();
+    flutterLFO.reset();
+    vinylRumbleLP.reset();
+    seedNoise();
+}
+
+void GrapeFlavor::reportMemory (MemoryReport& report, const juce::String& owner) const
+{
+    report.add (owner, "engine object", sizeof (GrapeFlavor));
+    FlavorEngine::reportMemory (report, owner);
+    report.add (owner, "morph table", morph.getMemoryBytes());
+    report.add (owner, "wow/flutter delay", wowFlutterDelay.getMemoryBytes());
+    report.add (owner, "crackle generators", crackle.size() * sizeof (CrackleGenerator));
+}
+
+void GrapeFlavor::copyChannelState (size_t source, size_t dest) noexcept
+{
+    // The vinyl layer is FLAT only, which never runs dual-mono
+    FlavorEngine::copyChannelState (source, dest);
+    dcBlocker.copyChannelState (source, dest);
+    wowFlutterDelay.copyChannelState (source, dest);
+    tapeLP.copyChannelState (source, dest);
+}
+
+void GrapeFlavor::seedNoise() noexcept
+{
+    rumbleNoise.seed (noiseSeed, 0);
+
+    for (size_t ch = 0; ch < crackle.size(); ++ch)
+        crackle[ch].seed (noiseSeed, 1 + ch);
+}
+
+void GrapeFlavor::buildMorphTable()
+{
+    const double sr = sampleRate;
+    auto msToSamples = [sr] (float ms) { return static_cast<float> (ms * 0.001 * sr); };
+
+    morph.build ([msToSamples] (float fizz)
+    {
+        Controls c {};
+        c.tapeDrive        = FizzCurves::exponential (fizz, 1.2f, 4.0f, 2.5f);
+        c.wowDepthSamples  = msToSamples (FizzCurves::exponential (fizz, 0.0f, kMaxWowDepthMs, 2.0f));
+        c.flutDepthSamples = msToSamples (FizzCurves::exponential (fizz, 0.0f, kMaxFlutterDepthMs, 2.0f));
+        c.lpCutoff         = FizzCurves::logarithmic (fizz, 16000.0f, 4000.0f, 2.0f);
+        // FLAT vinyl layer
+        c.crackleRate  = FizzCurves::exponential (fizz, 0.001f, 0.01f, 2.0f);
+        c.crackleLevel = FizzCurves::exponential (fizz, 0.01f, 0.05f, 2.0f);
+        c.rumbleLevel  = FizzCurves::exponential (fizz, 0.0f, 0.015f, 2.0f);
+        return c;
+    });
+}
+
+double GrapeFlavor::getTailLengthSeconds (bool carbonated) noexcept
+{
+    // FLAT's vinyl crackle and rumble play on through silence
+    if (! carbonated)
+        return std::numeric_limits<double>::infinity();
+
+    // 5Hz DC blocker (Butterworth SVF, Q 0.707), then the longest wow/flutter delay
+    return getDecaySeconds (5.0, 0.707) + (kBaseDelayMs + kMaxWowDepthMs + kMaxFlutterDepthMs) * 0.001;
+}
+
+template <bool carbonated>
+void GrapeFlavor::process (juce::dsp::AudioBlock<float>& block, juce::SmoothedValue<float>& fizz, size_t controlBlockSize)
+{
+    forEachControlBlock (block, fizz, controlBlockSize, [this] (juce::dsp::AudioBlock<float>& subBlock, float controlFizz)
+    {
+        const auto controls = morph.lookup (controlFizz);
+
+        processCarbonated (subBlock, controls);
+
+        if constexpr (! carbonated)
+            processVinyl (subBlock, controls);
+    });
+}
+
+template void GrapeFlavor::process<true> (juce::dsp::AudioBlock<float>&, juce::SmoothedValue<float>&, size_t);
+template void GrapeFlavor::process<false> (juce::dsp::AudioBlock<float>&, juce::SmoothedValue<float>&, size_t);
+
+void GrapeFlavor::processCarbonated (juce::dsp::AudioBlock<float>& block, const Controls& controls)
+{
+    const auto nSamples = block.getNumSamples();
+
+    // 1. Oversampled tape saturation with DC bias
+    SaturationEngine::Params satParams;
+    satParams.curve = SaturationEngine::CurveType::Tanh;
+    satParams.drive = controls.tapeDrive;
+    satParams.dcBias = 0.15f;
+
+    // + DC block
+    saturateAndFilter (block, satParams, dcBlocker);
+
+    // 2. Wow & Flutter via modulated delay: sine wow + triangle flutter
+    auto* delaySamples = scratch->allocate (nSamples);   // Per-sample delay
+    juce::FloatVectorOperations::fill (delaySamples, baseDelaySamples, static_cast<int> (nSamples));
+    wowLFO.addTo (delaySamples, nSamples, controls.wowDepthSamples);
+    flutterLFO.addTo (delaySamples, nSamples, controls.flutDepthSamples);
+    wowFlutterDelay.process (block, delaySamples, 1.0f);
+
+    // 3. Tape head LP filter
+    tapeLP.setSVF (0, FilterCascade::SVFType::LowPass, controls.lpCutoff);
+    tapeLP.process (block);
+}
+
+void GrapeFlavor::processVinyl (juce::dsp::AudioBlock<float>& block, const Controls& controls)
+{
+    // FLAT: Vinyl mode — crackle + rumble + mono below 300Hz
+    const auto nChannels = block.getNumChannels();
+    const auto nSamples = block.getNumSamples();
+
+    // Vinyl crackle: sparse random pops, only the event samples are visited
+    for (size_t ch = 0; ch < juce::jmin (nChannels, crackle.size()); ++ch)
+        crackle[ch].addTo (block.getChannelPointer (ch), nSamples, controls.crackleRate, controls.crackleLevel);
+
+    // 40Hz rumble: white noise through the rumble LP, shared by all channels
+    auto rumbleBlock = scratch->allocateBlock (1, nSamples);
+    auto* rumble = rumbleBlock.getChannelPointer (0);
+    rumbleNoise.fillBipolar (rumble, nSamples, controls.rumbleLevel * rumbleMakeup);
+    vinylRumbleLP.process (rumbleBlock);
+
+    for (size_t ch = 0; ch < nChannels; ++ch)
+        juce::FloatVectorOperations::add (block.getChannelPointer (ch), rumble, static_cast<int> (nSamples));
+
+    // Mono below 300Hz (stereo only)
+    if (nChannels >= 2)
+    {
+        auto* dataL = block.getChannelPointer (0);
+        auto* dataR = block.getChannelPointer (1);
+        for (size_t i = 0; i < nSamples; ++i)
+        {
+            float mid = (dataL[i] + dataR[i]) * 0.5f;
+            float sideL = dataL[i] - mid;
+            float sideR = dataR[i] - mid;
+            dataL[i] = mid + sideL;
+            dataR[i] = mid + sideR;
+        }
+    }
+}
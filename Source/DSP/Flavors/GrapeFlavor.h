@@ -0,0 +1,65 @@
+#pragma once
+
+#include "FlavorEngine.h"
+#include "DSP/ModulatedDelayLine.h"
+#include "DSP/ModulationLFO.h"
+#include "DSP/NoiseGenerator.h"
+
+/**
+ * GRAPE — Lo-Fi Tape Texture
+ * Biased tape saturation -> DC blocker -> wow & flutter -> tape head LP.
+ * FLAT adds a vinyl layer (crackle, rumble, mono lows).
+ */
+class GrapeFlavor final : public FlavorEngine
+{
+public:
+    void prepare (const juce::dsp::ProcessSpec& spec) override;
+    void reset() override;
+    void reportMemory (MemoryReport& report, const juce::String& owner) const override;
+    void copyChannelState (size_t source, size_t dest) noexcept override;
+    void setNoiseSeed (std::uint64_t seed) noexcept override { noiseSeed = seed; }
+
+    /** Time the output takes to decay to silence once the input stops */
+    static double getTailLengthSeconds (bool carbonated) noexcept;
+
+    /** FLAT's crackle is random per channel */
+    static bool isChannelSymmetric (bool carbonated) noexcept { return carbonated; }
+
+    /** Runs a host block at control rate, Fizz taken from the smoother */
+    template <bool carbonated>
+    void process (juce::dsp::AudioBlock<float>& block, juce::SmoothedValue<float>& fizz, size_t controlBlockSize);
+
+private:
+    struct Controls
+    {
+        float tapeDrive, wowDepthSamples, flutDepthSamples, lpCutoff;
+        float crackleRate, crackleLevel, rumbleLevel;
+    };
+
+    void buildMorphTable();
+
+    void processCarbonated (juce::dsp::AudioBlock<float>& block, const Controls& controls);
+
+    /** FLAT: vinyl layer, run after the carbonated chain */
+    void processVinyl (juce::dsp::AudioBlock<float>& block, const Controls& controls);
+
+    FizzMorphTable<Controls> morph;
+
+    FilterCascade dcBlocker;          // SVF HP @ 5Hz
+    FilterCascade tapeLP;             // SVF LP, Fizz-swept
+    ModulatedDelayLine wowFlutterDelay;
+    ModulationLFO wowLFO;             // Sine, 0.4Hz
+    ModulationLFO flutterLFO;         // Triangle, 4.5Hz
+    float baseDelaySamples = 0.0f;
+
+    // FLAT: vinyl layer. Noise streams are reseeded on reset(), so renders
+    // from the same start point are bit-identical.
+    void seedNoise() noexcept;
+
+    std::uint64_t noiseSeed = kDefaultNoiseSeed;
+
+    std::vector<CrackleGenerator> crackle;   // One stream per channel
+    NoiseGenerator rumbleNoise;
+    FilterCascade vinylRumbleLP;      // SVF LP @ 40Hz, mono
+    float rumbleMakeup = 1.0f;        // Restores the white-noise RMS after the LP
+};
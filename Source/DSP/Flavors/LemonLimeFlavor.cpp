@@ -0,0 +1,137 @@
+#include "LemonLimeFlavor.h"
+#include "DSP/FizzCurves.h"
+
+void LemonLimeFlavor::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    prepareEngine (spec);
+    buildMorphTable();
+
+    crossover.prepare (subBlockSpec, 2, *scratch);
+    hfCompressor.prepare (spec);
+    hfCompressor.setRatio (4.0f);
+    hfCompressor.setThreshold (-20.0f);
+    hfCompressor.setRelease (50.0f);
+    compAttack = 0.0f;
+    toneEQ.prepare (subBlockSpec, 2, *scratch);
+    teleEQ.prepare (subBlockSpec, 2, *scratch);
+}
+
+void LemonLimeFlavor::reset()
+{
+    saturationEngine.reset();
+    crossover.reset();
+    hfCompressor.reset();
+    toneEQ.reset();
+    teleEQ.reset();
+}
+
+void LemonLimeFlavor::reportMemory (MemoryReport& report, const juce::String& owner) const
+{
+    report.add (owner, "engine object", sizeof (LemonLimeFlavor));
+    FlavorEngine::reportMemory (report, owner);
+    report.add (owner, "morph table", morph.getMemoryBytes());
+}
+
+void LemonLimeFlavor::copyChannelState (size_t source, size_t dest) noexcept
+{
+    // The compressor's envelope is internal to juce::dsp::Compressor: it
+    // catches up within its attack/release
+    FlavorEngine::copyChannelState (source, dest);
+    crossover.copyChannelState (source, dest);
+    toneEQ.copyChannelState (source, dest);
+    teleEQ.copyChannelState (source, dest);
+}
+
+void LemonLimeFlavor::buildMorphTable()
+{
+    using Type = BiquadDesign::Type;
+    const double sr = sampleRate;
+
+    morph.build ([sr] (float fizz)
+    {
+        Controls c {};
+        c.crossoverFreq = FizzCurves::logarithmic (fizz, 4000.0f, 1500.0f, 2.0f);
+        c.hfDrive       = FizzCurves::exponential (fizz, 1.3f, 3.5f, 2.5f);
+        c.hfDriveInv    = 1.0f / c.hfDrive;
+        c.compAttack    = FizzCurves::exponential (fizz, 10.0f, 0.5f, 2.0f);
+        BiquadDesign::design (Type::Peak, sr, 5000.0f, 1.5f,
+                              FizzCurves::logarithmic (fizz, 0.5f, 6.0f, 1.8f), c.presence);
+        BiquadDesign::design (Type::HighShelf, sr, 10000.0f, 0.707f,
+                              FizzCurves::logarithmic (fizz, 0.5f, 5.0f, 1.8f), c.airShelf);
+        // FLAT telephone band-pass
+        const float resonance = FizzCurves::exponential (fizz, 0.707f, 3.0f, 2.0f);
+        BiquadDesign::design (Type::HighPass, sr, 300.0f, resonance, 0.0f, c.teleHighPass);
+        BiquadDesign::design (Type::LowPass, sr, 3500.0f, resonance, 0.0f, c.teleLowPass);
+        return c;
+    });
+}
+
+double LemonLimeFlavor::getTailLengthSeconds (bool carbonated) noexcept
+{
+    // Two Butterworth sections at the lowest crossover frequency, plus the
+    // telephone band-pass at its most resonant (300Hz, Q 3) in FLAT
+    const double crossoverTail = 2.0 * getDecaySeconds (1500.0, 0.707);
+    return carbonated ? crossoverTail : crossoverTail + getDecaySeconds (300.0, 3.0);
+}
+
+template <bool carbonated>
+void LemonLimeFlavor::process (juce::dsp::AudioBlock<float>& block, juce::SmoothedValue<float>& fizz, size_t controlBlockSize)
+{
+    forEachControlBlock (block, fizz, controlBlockSize, [this] (juce::dsp::AudioBlock<float>& subBlock, float controlFizz)
+    {
+        const auto controls = morph.lookup (controlFizz);
+
+        processCarbonated (subBlock, controls);
+
+        if constexpr (! carbonated)
+            processTelephone (subBlock, controls);
+    });
+}
+
+template void LemonLimeFlavor::process<true> (juce::dsp::AudioBlock<float>&, juce::SmoothedValue<float>&, size_t);
+template void LemonLimeFlavor::process<false> (juce::dsp::AudioBlock<float>&, juce::SmoothedValue<float>&, size_t);
+
+void LemonLimeFlavor::processCarbonated (juce::dsp::AudioBlock<float>& block, const Controls& controls)
+{
+    const auto nChannels = block.getNumChannels();
+    const auto nSamples = block.getNumSamples();
+
+    // 1. Linkwitz-Riley 4th-order crossover, one pass: the low band goes to
+    //    the crossover's band buffer, the high band stays in the block
+    crossover.setCrossoverFrequency (0, controls.crossoverFreq);
+    crossover.process (block);
+
+    // 2. Oversampled HF band saturation via SaturationEngine
+    SaturationEngine::Params satParams;
+    satParams.curve = SaturationEngine::CurveType::Tanh;
+    satParams.drive = controls.hfDrive;
+    satParams.outputGain = controls.hfDriveInv;
+    saturationEngine.process (block, satParams);
+
+    // 3. Fast envelope compressor on HF
+    if (controls.compAttack != compAttack)
+        hfCompressor.setAttack (compAttack = controls.compAttack);
+    {
+        juce::dsp::ProcessContextReplacing<float> ctx (block);
+        hfCompressor.process (ctx);
+    }
+
+    // 4-5. Presence bell @ 5kHz + air shelf @ 10kHz, one pass
+    toneEQ.setBiquad (0, controls.presence);
+    toneEQ.setBiquad (1, controls.airShelf);
+    toneEQ.process (block);
+
+    // 6. Sum LOW + HIGH (LR4 sums flat)
+    auto lowBand = crossover.getBand (0);
+    for (size_t ch = 0; ch < nChannels; ++ch)
+        juce::FloatVectorOperations::add (block.getChannelPointer (ch), lowBand.getChannelPointer (ch),
+                                          static_cast<int> (nSamples));
+}
+
+void LemonLimeFlavor::processTelephone (juce::dsp::AudioBlock<float>& block, const Controls& controls)
+{
+    // FLAT: Telephone EQ — bandpass 300Hz–3.5kHz with resonant peaks
+    teleEQ.setBiquad (0, controls.teleHighPass);
+    teleEQ.setBiquad (1, controls.teleLowPass);
+    teleEQ.process (block);
+}
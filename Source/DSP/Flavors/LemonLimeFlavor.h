@@ -0,0 +1,50 @@
+#pragma once
+
+#include "FlavorEngine.h"
+#include "DSP/LinkwitzRileyCrossover.h"
+
+/**
+ * LEMON-LIME — Crisp Exciter
+ * LR4 crossover; the high band is saturated, compressed and EQ'd, then
+ * summed back with the untouched low band.
+ * FLAT adds a resonant telephone band-pass.
+ */
+class LemonLimeFlavor final : public FlavorEngine
+{
+public:
+    void prepare (const juce::dsp::ProcessSpec& spec) override;
+    void reset() override;
+    void reportMemory (MemoryReport& report, const juce::String& owner) const override;
+    void copyChannelState (size_t source, size_t dest) noexcept override;
+
+    /** Time the output takes to decay to silence once the input stops */
+    static double getTailLengthSeconds (bool carbonated) noexcept;
+
+    /** Runs a host block at control rate, Fizz taken from the smoother */
+    template <bool carbonated>
+    void process (juce::dsp::AudioBlock<float>& block, juce::SmoothedValue<float>& fizz, size_t controlBlockSize);
+
+private:
+    struct Controls
+    {
+        float crossoverFreq, hfDrive, hfDriveInv, compAttack;
+        float presence[kNumCoeffs], airShelf[kNumCoeffs];
+        float teleHighPass[kNumCoeffs], teleLowPass[kNumCoeffs];
+    };
+
+    void buildMorphTable();
+
+    void processCarbonated (juce::dsp::AudioBlock<float>& block, const Controls& controls);
+
+    /** FLAT: telephone EQ, run after the carbonated chain */
+    void processTelephone (juce::dsp::AudioBlock<float>& block, const Controls& controls);
+
+    FizzMorphTable<Controls> morph;
+
+    LinkwitzRileyCrossover crossover; // LR4, 2 bands: low -> band buffer, high in place
+    juce::dsp::Compressor<float> hfCompressor;
+    float compAttack = 0.0f;          // Last value pushed to hfCompressor
+    FilterCascade toneEQ;             // Presence bell + air shelf
+    // FLAT: telephone EQ
+    FilterCascade teleEQ;             // High-pass + low-pass
+};
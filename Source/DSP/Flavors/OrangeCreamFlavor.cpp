@@ -0,0 +1,119 @@
+#include "OrangeCreamFlavor.h"
+#include "DSP/FizzCurves.h"
+
+void OrangeCreamFlavor::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    prepareEngine (spec);
+    buildMorphTables();
+
+    filter.prepare (subBlockSpec, 3, *scratch);
+}
+
+void OrangeCreamFlavor::reset()
+{
+    saturationEngine.reset();
+    filter.reset();
+}
+
+void OrangeCreamFlavor::reportMemory (MemoryReport& report, const juce::String& owner) const
+{
+    report.add (owner, "engine object", sizeof (OrangeCreamFlavor));
+    FlavorEngine::reportMemory (report, owner);
+    report.add (owner, "morph tables", morph.getMemoryBytes() + flatMorph.getMemoryBytes());
+}
+
+void OrangeCreamFlavor::copyChannelState (size_t source, size_t dest) noexcept
+{
+    FlavorEngine::copyChannelState (source, dest);
+    filter.copyChannelState (source, dest);
+}
+
+void OrangeCreamFlavor::buildMorphTables()
+{
+    using Type = BiquadDesign::Type;
+    const double sr = sampleRate;
+
+    morph.build ([sr] (float fizz)
+    {
+        Controls c {};
+        // Drive: gentle warmth that increases as you close the filter
+        c.drive      = FizzCurves::exponential (fizz, 1.0f, 2.5f, 2.0f);
+        // LP cutoff sweeps from wide open down to 200Hz
+        c.lpCutoff   = FizzCurves::logarithmic (fizz, 20000.0f, 200.0f, 2.5f);
+        // Resonance adds filter character as it closes; stage 2 stays Butterworth
+        c.resonance1 = FizzCurves::sCurve (fizz, 0.707f, 2.5f);
+        c.resonance2 = 0.707f;
+        // Low shelf boost keeps the bass full as highs are removed
+        BiquadDesign::design (Type::LowShelf, sr, 200.0f, 0.707f,
+                              FizzCurves::logarithmic (fizz, 0.0f, 4.0f, 1.8f), c.lowShelf);
+        return c;
+    });
+
+    flatMorph.build ([sr] (float fizz)
+    {
+        // More aggressive parameters for the dirty version
+        Controls c {};
+        c.drive      = FizzCurves::exponential (fizz, 1.5f, 4.0f, 2.0f);
+        c.lpCutoff   = FizzCurves::logarithmic (fizz, 20000.0f, 100.0f, 2.5f);
+        c.resonance1 = FizzCurves::sCurve (fizz, 0.707f, 4.0f);
+        c.resonance2 = c.resonance1 * 0.5f;
+        BiquadDesign::design (Type::LowShelf, sr, 200.0f, 0.707f,
+                              FizzCurves::logarithmic (fizz, 0.0f, 6.0f, 1.8f), c.lowShelf);
+        return c;
+    });
+}
+
+double OrangeCreamFlavor::getTailLengthSeconds (bool carbonated) noexcept
+{
+    // Resonant low-pass fully closed: 200Hz at Q 2.5, FLAT 100Hz at Q 4
+    return carbonated ? getDecaySeconds (200.0, 2.5) : getDecaySeconds (100.0, 4.0);
+}
+
+template <bool carbonated>
+void OrangeCreamFlavor::process (juce::dsp::AudioBlock<float>& block, juce::SmoothedValue<float>& fizz, size_t controlBlockSize)
+{
+    forEachControlBlock (block, fizz, controlBlockSize, [this] (juce::dsp::AudioBlock<float>& subBlock, float controlFizz)
+    {
+        if constexpr (carbonated)
+            processCarbonated (subBlock, morph.lookup (controlFizz));
+        else
+            processFlat (subBlock, flatMorph.lookup (controlFizz));
+    });
+}
+
+template void OrangeCreamFlavor::process<true> (juce::dsp::AudioBlock<float>&, juce::SmoothedValue<float>&, size_t);
+template void OrangeCreamFlavor::process<false> (juce::dsp::AudioBlock<float>&, juce::SmoothedValue<float>&, size_t);
+
+void OrangeCreamFlavor::processCarbonated (juce::dsp::AudioBlock<float>& block, const Controls& controls)
+{
+    // 1. Warm drive saturation (pre-filter for analog character)
+    SaturationEngine::Params satParams;
+    satParams.curve = SaturationEngine::CurveType::WarmClip;
+    satParams.drive = controls.drive;
+
+    // 2. Resonant lowpass filter (4th-order: two cascaded SVTPF stages)
+    //    Stage 1: resonant — provides the filter sweep character
+    //    Stage 2: fixed Q — adds steepness for a 24dB/oct rolloff
+    // 3. Low shelf boost @ 200Hz to keep the low end full
+    //    All three stages in one pass
+    filter.setSVF (0, FilterCascade::SVFType::LowPass, controls.lpCutoff, controls.resonance1);
+    filter.setSVF (1, FilterCascade::SVFType::LowPass, controls.lpCutoff, controls.resonance2);
+    filter.setBiquad (2, controls.lowShelf);
+    saturateAndFilter (block, satParams, filter);
+}
+
+void OrangeCreamFlavor::processFlat (juce::dsp::AudioBlock<float>& block, const Controls& controls)
+{
+    // FLAT: dirtier version — heavier drive, more resonance, filter goes lower
+    // 1. Heavier tanh saturation (grittier than WarmClip)
+    SaturationEngine::Params satParams;
+    satParams.curve = SaturationEngine::CurveType::Tanh;
+    satParams.drive = controls.drive;
+
+    // 2. Resonant lowpass filter (4th-order, both stages resonant for aggression)
+    // 3. Low shelf boost to fatten up the bottom end
+    filter.setSVF (0, FilterCascade::SVFType::LowPass, controls.lpCutoff, controls.resonance1);
+    filter.setSVF (1, FilterCascade::SVFType::LowPass, controls.lpCutoff, controls.resonance2);
+    filter.setBiquad (2, controls.lowShelf);
+    saturateAndFilter (block, satParams, filter);
+}
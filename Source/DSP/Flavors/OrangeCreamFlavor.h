@@ -0,0 +1,42 @@
+#pragma once
+
+#include "FlavorEngine.h"
+
+/**
+ * ORANGE CREAM — Lowpass Filter + Drive (OneKnob Filter style)
+ * Warm drive -> resonant 4th-order SVF low-pass -> low shelf, one pass.
+ * FLAT is a dirtier variant with its own Fizz map.
+ */
+class OrangeCreamFlavor final : public FlavorEngine
+{
+public:
+    void prepare (const juce::dsp::ProcessSpec& spec) override;
+    void reset() override;
+    void reportMemory (MemoryReport& report, const juce::String& owner) const override;
+    void copyChannelState (size_t source, size_t dest) noexcept override;
+
+    /** Time the output takes to decay to silence once the input stops */
+    static double getTailLengthSeconds (bool carbonated) noexcept;
+
+    /** Runs a host block at control rate, Fizz taken from the smoother */
+    template <bool carbonated>
+    void process (juce::dsp::AudioBlock<float>& block, juce::SmoothedValue<float>& fizz, size_t controlBlockSize);
+
+private:
+    struct Controls
+    {
+        float drive, lpCutoff, resonance1, resonance2;
+        float lowShelf[kNumCoeffs];
+    };
+
+    void buildMorphTables();
+
+    void processCarbonated (juce::dsp::AudioBlock<float>& block, const Controls& controls);
+    void processFlat (juce::dsp::AudioBlock<float>& block, const Controls& controls);
+
+    FizzMorphTable<Controls> morph;
+    FizzMorphTable<Controls> flatMorph;
+
+    // Resonant SVF LP stage 1 + steep SVF LP stage 2 + low shelf, one pass
+    FilterCascade filter;
+};
@@ -0,0 +1,120 @@
+#include "LatencyCompensator.h"
+#include <cmath>
+
+void LatencyCompensator::prepare (int numChannels, float maxDelaySamples)
+{
+    ScratchArena::assertNotOnAudioThread();
+
+    const int size = juce::nextPowerOfTwo (static_cast<int> (std::ceil (juce::jmax (maxDelaySamples, 0.0f))) + 2);
+
+    buffer.setSize (juce::jmax (1, numChannels), size);
+    allpassState.assign (static_cast<size_t> (buffer.getNumChannels()), {});
+    mask = size - 1;
+
+    delaySamples = -1.0f;
+    setDelay (0.0f);
+    reset();
+}
+
+void LatencyCompensator::reset() noexcept
+{
+    buffer.clear();
+    std::fill (allpassState.begin(), allpassState.end(), AllpassState {});
+    writePos = 0;
+}
+
+void LatencyCompensator::setDelay (float newDelaySamples) noexcept
+{
+    newDelaySamples = juce::jlimit (0.0f, static_cast<float> (mask - 1), newDelaySamples);
+
+    if (newDelaySamples == delaySamples)
+        return;
+
+    // Pass-through doesn't feed the ring buffer: don't replay what it held
+    if (delaySamples < 0.5f)
+        buffer.clear();
+
+    delaySamples = newDelaySamples;
+
+    if (delaySamples < 0.5f)
+    {
+        integerDelay = 0;
+        coefficient = 0.0f;
+    }
+    else
+    {
+        // d in [0.5, 1.5): the Thiran section carries the fraction plus one
+        // borrowed sample, the ring buffer the rest
+        integerDelay = static_cast<int> (std::floor (delaySamples - 0.5f));
+        const float d = delaySamples - static_cast<float> (integerDelay);
+        coefficient = (1.0f - d) / (1.0f + d);
+    }
+
+    std::fill (allpassState.begin(), allpassState.end(), AllpassState {});
+}
+
+void LatencyCompensator::process (juce::dsp::AudioBlock<float>& block) noexcept
+{
+    if (delaySamples < 0.5f)
+        return;
+
+    const auto nChannels = juce::jmin (block.getNumChannels(), static_cast<size_t> (buffer.getNumChannels()));
+    const auto nSamples = block.getNumSamples();
+    const float a = coefficient;
+
+    for (size_t ch = 0; ch < nChannels; ++ch)
+    {
+        auto* data = block.getChannelPointer (ch);
+        auto* line = buffer.getWritePointer (static_cast<int> (ch));
+        auto st = allpassState[ch];
+        int w = writePos;
+
+        for (size_t i = 0; i < nSamples; ++i)
+        {
+            line[w] = data[i];
+            const float v = line[(w - integerDelay) & mask];
+            w = (w + 1) & mask;
+
+            // y[n] = a * v[n] + v[n-1] - a * y[n-1]
+            const float y = a * (v - st.lastOutput) + st.lastInput;
+            st.lastInput = v;
+            st.lastOutput = y;
+            data[i] = y;
+        }
+
+        allpassState[ch] = st;
+    }
+
+    writePos = (writePos + static_cast<int> (nSamples)) & mask;
+}
+
+void LatencyCompensator::push (const juce::dsp::AudioBlock<const float>& block) noexcept
+{
+    if (delaySamples < 0.5f)
+        return;
+
+    const auto nChannels = juce::jmin (block.getNumChannels(), static_cast<size_t> (buffer.getNumChannels()));
+    const auto nSamples = block.getNumSamples();
+
+    for (size_t ch = 0; ch < nChannels; ++ch)
+    {
+        const auto* data = block.getChannelPointer (ch);
+        auto* line = buffer.getWritePointer (static_cast<int> (ch));
+
+        // At most two contiguous runs around the wrap
+        size_t done = 0;
+        int w = writePos;
+        while (done < nSamples)
+        {
+            const auto run = juce::jmin (nSamples - done, static_cast<size_t> (mask + 1 - w));
+            std::copy (data + done, data + done + run, line + w);
+            done += run;
+            w = (w + static_cast<int> (run)) & mask;
+        }
+
+        // The allpass resumes from silence once process() is called again
+        allpassState[ch] = {};
+    }
+
+    writePos = (writePos + static_cast<int> (nSamples)) & mask;
+}
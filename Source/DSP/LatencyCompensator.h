@@ -0,0 +1,55 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "ScratchArena.h"
+
+/**
+ * Fixed delay of any non-negative, non-integer length, used to pad the
+ * faster quality settings up to the constant latency Carbonator reports.
+ * The integer part is a power-of-two ring buffer; the fraction is a
+ * first-order Thiran allpass (flat magnitude, maximally flat group delay),
+ * kept in its well-behaved range of 0.5-1.5 samples by borrowing one sample
+ * from the integer part. Two multiplies per sample, whatever the delay.
+ */
+class LatencyCompensator
+{
+public:
+    LatencyCompensator() = default;
+
+    /** Allocates room for delays of up to maxDelaySamples */
+    void prepare (int numChannels, float maxDelaySamples);
+    void reset() noexcept;
+
+    /** Delays below half a sample pass the signal through untouched. Audio
+     *  thread safe; the allpass state is cleared only when the delay changes. */
+    void setDelay (float newDelaySamples) noexcept;
+
+    float getDelay() const noexcept { return delaySamples; }
+
+    void process (juce::dsp::AudioBlock<float>& block) noexcept;
+
+    /** Feeds the block into the line without producing output: keeps the line
+     *  current while nobody listens to it, at the cost of a copy */
+    void push (const juce::dsp::AudioBlock<const float>& block) noexcept;
+
+    /** Heap held by the ring buffers */
+    size_t getMemoryBytes() const noexcept
+    {
+        return static_cast<size_t> (buffer.getNumChannels() * buffer.getNumSamples()) * sizeof (float);
+    }
+
+private:
+    struct AllpassState
+    {
+        float lastInput = 0.0f;
+        float lastOutput = 0.0f;
+    };
+
+    juce::AudioBuffer<float> buffer;
+    std::vector<AllpassState> allpassState;
+    float delaySamples = 0.0f;
+    float coefficient = 0.0f;       // Thiran: (1 - d) / (1 + d)
+    int integerDelay = 0;
+    int mask = 0;
+    int writePos = 0;
+};
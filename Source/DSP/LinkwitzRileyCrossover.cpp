@@ -0,0 +1,153 @@
+#include "LinkwitzRileyCrossover.h"
+#include <cmath>
+
+// Butterworth sections: R2 = 2 * damping = sqrt(2)
+static constexpr float kR2 = juce::MathConstants<float>::sqrt2;
+
+void LinkwitzRileyCrossover::prepare (const juce::dsp::ProcessSpec& spec, int newNumBands, ScratchArena& scratchToUse)
+{
+    ScratchArena::assertNotOnAudioThread();
+    jassert (newNumBands >= 2 && newNumBands <= kMaxBands);
+    jassert (spec.numChannels <= static_cast<juce::uint32> (kMaxChannels));
+
+    sampleRate = spec.sampleRate;
+    numBands = juce::jlimit (2, kMaxBands, newNumBands);
+    numChannels = juce::jlimit (1, kMaxChannels, static_cast<int> (spec.numChannels));
+
+    scratch = &scratchToUse;
+
+    splits.fill ({});
+    for (int k = 0; k < numBands - 1; ++k)
+        setCrossoverFrequency (k, 1000.0f);
+
+    reset();
+}
+
+void LinkwitzRileyCrossover::reset() noexcept
+{
+    state.fill ({});
+    lowerBands = {};
+}
+
+void LinkwitzRileyCrossover::setCrossoverFrequency (int index, float frequency) noexcept
+{
+    jassert (index >= 0 && index < numBands - 1);
+    auto& split = splits[static_cast<size_t> (index)];
+
+    if (split.frequency == frequency)
+        return;
+
+    const double g = std::tan (juce::MathConstants<double>::pi * frequency / sampleRate);
+    const double R2 = static_cast<double> (kR2);
+
+    split.frequency = frequency;
+    split.g = static_cast<float> (g);
+    split.gPlusR2 = static_cast<float> (g + R2);
+    split.h = static_cast<float> (1.0 / (1.0 + R2 * g + g * g));
+}
+
+void LinkwitzRileyCrossover::process (juce::dsp::AudioBlock<float>& block) noexcept
+{
+    const auto nChannels = juce::jmin (block.getNumChannels(), static_cast<size_t> (numChannels));
+    const auto nSamples = block.getNumSamples();
+
+    jassert (scratch != nullptr);
+    lowerBands = scratch->allocateBlock (static_cast<size_t> (numBands - 1) * nChannels, nSamples);
+
+    for (size_t ch = 0; ch < nChannels; ++ch)
+    {
+        float* bands[kMaxSplits] {};
+        for (int b = 0; b < numBands - 1; ++b)
+            bands[b] = lowerBands.getChannelPointer (static_cast<size_t> (b) * nChannels + ch);
+
+        auto* data = block.getChannelPointer (ch);
+        auto& st = state[ch];
+
+        switch (numBands)
+        {
+            case 2:  processChannel<2> (data, bands, nSamples, st); break;
+            case 3:  processChannel<3> (data, bands, nSamples, st); break;
+            default: processChannel<4> (data, bands, nSamples, st); break;
+        }
+    }
+}
+
+juce::dsp::AudioBlock<float> LinkwitzRileyCrossover::getBand (int band) const noexcept
+{
+    jassert (band >= 0 && band < numBands - 1);
+    const auto nChannels = lowerBands.getNumChannels() / static_cast<size_t> (numBands - 1);
+    return lowerBands.getSubsetChannelBlock (static_cast<size_t> (band) * nChannels, nChannels);
+}
+
+template <int bands>
+void LinkwitzRileyCrossover::processChannel (float* data, float* const* bandData, size_t numSamples,
+                                             ChannelState& st) const noexcept
+{
+    constexpr int numSplits = bands - 1;
+
+    // Coefficients and state in locals for the whole block
+    Split sp[numSplits];
+    float s[numSplits][4];
+    float ap[numSplits][numSplits][2];
+
+    for (int k = 0; k < numSplits; ++k)
+    {
+        sp[k] = splits[static_cast<size_t> (k)];
+        for (int v = 0; v < 4; ++v)
+            s[k][v] = st.split[k][v];
+        for (int j = 0; j < k; ++j)
+            for (int v = 0; v < 2; ++v)
+                ap[j][k][v] = st.allpass[j][k][v];
+    }
+
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        float x = data[i];
+
+        for (int k = 0; k < numSplits; ++k)
+        {
+            const float g = sp[k].g, gR2 = sp[k].gPlusR2, h = sp[k].h;
+
+            // Shared section: LP2 and AP2 = x - 2 * R2 * BP2 from one state
+            const float hp = h * (x - gR2 * s[k][0] - s[k][1]);
+            const float bp = g * hp + s[k][0];
+            s[k][0] = g * hp + bp;
+            const float lp = g * bp + s[k][1];
+            s[k][1] = g * bp + lp;
+            const float allpass = x - 2.0f * kR2 * bp;
+
+            // Second low-pass section: LP4
+            const float hp2 = h * (lp - gR2 * s[k][2] - s[k][3]);
+            const float bp2 = g * hp2 + s[k][2];
+            s[k][2] = g * hp2 + bp2;
+            const float lp2 = g * bp2 + s[k][3];
+            s[k][3] = g * bp2 + lp2;
+
+            // Phase-align the bands already split off with this split's allpass
+            for (int j = 0; j < k; ++j)
+            {
+                const float y = bandData[j][i];
+                const float hpj = h * (y - gR2 * ap[j][k][0] - ap[j][k][1]);
+                const float bpj = g * hpj + ap[j][k][0];
+                ap[j][k][0] = g * hpj + bpj;
+                const float lpj = g * bpj + ap[j][k][1];
+                ap[j][k][1] = g * bpj + lpj;
+                bandData[j][i] = y - 2.0f * kR2 * bpj;
+            }
+
+            bandData[k][i] = lp2;
+            x = allpass - lp2;    // HP4, split further by the next section
+        }
+
+        data[i] = x;
+    }
+
+    for (int k = 0; k < numSplits; ++k)
+    {
+        for (int v = 0; v < 4; ++v)
+            st.split[k][v] = s[k][v];
+        for (int j = 0; j < k; ++j)
+            for (int v = 0; v < 2; ++v)
+                st.allpass[j][k][v] = ap[j][k][v];
+    }
+}
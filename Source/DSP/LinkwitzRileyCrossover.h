@@ -0,0 +1,87 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "ScratchArena.h"
+
+/**
+ * Linkwitz-Riley 4th-order band splitter for Carbonator
+ * Each split is one TPT state-variable section shared by both outputs plus a
+ * second low-pass section (as juce::dsp::LinkwitzRileyFilter): the first
+ * section yields LP2 and the allpass AP2 from the same state, LP4 = LP2 * LP2,
+ * and HP4 = AP2 - LP4 — two SVF ticks per split instead of four, and both
+ * bands come out of one pass over the input.
+ * Up to kMaxBands bands (numBands - 1 ascending crossover frequencies). The
+ * top band replaces the input block in place; the lower bands are written to
+ * a block taken from the owner's ScratchArena. With more than two bands, each
+ * lower band also goes through the allpass of every split above it, so the
+ * bands still sum to an allpass response (flat magnitude).
+ */
+class LinkwitzRileyCrossover
+{
+public:
+    static constexpr int kMaxBands = 4;
+    static constexpr int kMaxChannels = 8;
+
+    LinkwitzRileyCrossover() = default;
+
+    /** process() takes the lower bands from scratch (see getScratchBytes()) */
+    void prepare (const juce::dsp::ProcessSpec& spec, int numBands, ScratchArena& scratch);
+    void reset() noexcept;
+
+    /** Channel dest's filter memory becomes a copy of channel source's */
+    void copyChannelState (size_t source, size_t dest) noexcept
+    {
+        jassert (source < static_cast<size_t> (kMaxChannels) && dest < static_cast<size_t> (kMaxChannels));
+        state[dest] = state[source];
+    }
+
+    /** Scratch the lower bands of one process() call take, for blocks of up to
+     *  spec.maximumBlockSize */
+    static size_t getScratchBytes (const juce::dsp::ProcessSpec& spec, int numBands) noexcept
+    {
+        return ScratchArena::getBlockBytes (static_cast<size_t> ((numBands - 1) * static_cast<int> (spec.numChannels)),
+                                            static_cast<size_t> (spec.maximumBlockSize));
+    }
+
+    /** Frequency of split `index` (0 = lowest, numBands - 2 = highest). The
+     *  tan() prewarp is only recomputed when the frequency actually changes. */
+    void setCrossoverFrequency (int index, float frequency) noexcept;
+
+    /** Splits the block: bands 0 .. numBands - 2 go to getBand(), the top band
+     *  is left in block. The lower bands live in the scratch arena until the
+     *  caller's enclosing ScratchArena::Scope closes. */
+    void process (juce::dsp::AudioBlock<float>& block) noexcept;
+
+    /** Lower band `band` (< numBands - 1) from the last process() call */
+    juce::dsp::AudioBlock<float> getBand (int band) const noexcept;
+
+    int getNumBands() const noexcept { return numBands; }
+
+private:
+    static constexpr int kMaxSplits = kMaxBands - 1;
+
+    struct Split
+    {
+        float g = 0.0f, gPlusR2 = 0.0f, h = 1.0f;   // As FilterCascade's SVF stages
+        float frequency = 0.0f;
+    };
+
+    /** Per channel: the split sections, then the compensation allpasses
+     *  (band j through split k, j < k) */
+    struct ChannelState
+    {
+        float split[kMaxSplits][4] {};
+        float allpass[kMaxSplits][kMaxSplits][2] {};
+    };
+
+    template <int bands>
+    void processChannel (float* data, float* const* bandData, size_t numSamples, ChannelState& st) const noexcept;
+
+    std::array<Split, kMaxSplits> splits;
+    std::array<ChannelState, kMaxChannels> state;
+    ScratchArena* scratch = nullptr;
+    juce::dsp::AudioBlock<float> lowerBands;   // [band * channels + channel], last process()
+    int numBands = 2;
+    int numChannels = 2;
+    double sampleRate = 44100.0;
+};
@@ -0,0 +1,32 @@
+#include "LoudnessMeter.h"
+#include <cmath>
+
+void LoudnessMeter::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    jassert (spec.numChannels <= static_cast<juce::uint32> (kMaxChannels));
+
+    numChannels = juce::jlimit (1, kMaxChannels, static_cast<int> (spec.numChannels));
+    numVecs = (numChannels + kLanes - 1) / kLanes;
+
+    BiquadDesign::kWeightingShelf (coefficients[0], spec.sampleRate);
+    BiquadDesign::kWeightingHighPass (coefficients[1], spec.sampleRate);
+    integratorCoefficient = static_cast<float> (1.0 - std::exp (-1.0 / (kIntegrationSeconds * spec.sampleRate)));
+
+    reset();
+}
+
+void LoudnessMeter::reset() noexcept
+{
+    state1 = {};
+    state2 = {};
+    meanSquare = {};
+}
+
+float LoudnessMeter::getMeanSquare() const noexcept
+{
+    float sum = 0.0f;
+    for (int v = 0; v < numVecs; ++v)
+        sum += meanSquare[static_cast<size_t> (v)].sum();
+
+    return sum;
+}
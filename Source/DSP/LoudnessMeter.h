@@ -0,0 +1,130 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "BiquadDesign.h"
+
+/**
+ * K-weighted loudness (ITU-R BS.1770) for Carbonator's auto-gain
+ * Each channel goes through the standard's two K-weighting biquads and its
+ * square feeds a one-pole integrator advanced every sample, so the averaging
+ * time is kIntegrationSeconds whatever block size the host uses. As in
+ * FilterCascade, the channels are packed into juce::dsp::SIMDRegister lanes:
+ * one register advances every channel's filters and integrator at once.
+ * processAndApplyGain() fuses a per-sample gain into the measuring pass, so
+ * the block is read and written only once.
+ */
+class LoudnessMeter
+{
+public:
+    static constexpr int kMaxChannels = 8;
+
+    /** Time constant of the integrator — about what the old per-block RMS
+     *  average gave at 512-sample blocks, now fixed in time */
+    static constexpr double kIntegrationSeconds = 1.0;
+
+    /** BS.1770 absolute gate, -70 LKFS, as a channel-summed mean square */
+    static constexpr float kGateMeanSquare = 1.17e-7f;
+
+    LoudnessMeter() = default;
+
+    void prepare (const juce::dsp::ProcessSpec& spec);
+    void reset() noexcept;
+
+    /** Measures the block, leaving it untouched */
+    void process (const juce::dsp::AudioBlock<float>& block) noexcept
+    {
+        run<false> (block, [] { return 1.0f; });
+    }
+
+    /** Measures the block and, in the same pass, scales every channel by
+     *  nextGain() (called once per sample). The measurement is of the signal
+     *  before the gain. */
+    template <typename NextGain>
+    void processAndApplyGain (const juce::dsp::AudioBlock<float>& block, NextGain&& nextGain) noexcept
+    {
+        run<true> (block, nextGain);
+    }
+
+    /** K-weighted mean square, summed over the channels (BS.1770 weights
+     *  every front channel 1.0); -0.691 + 10 log10 of it is the loudness in LKFS */
+    float getMeanSquare() const noexcept;
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int kLanes = static_cast<int> (Vec::SIMDNumElements);
+    static constexpr int kMaxVecs = (kMaxChannels + kLanes - 1) / kLanes;
+    static constexpr int kNumStages = 2;   // Shelf, then RLB high-pass
+
+    template <bool applyGain, typename NextGain>
+    void run (const juce::dsp::AudioBlock<float>& block, NextGain&& nextGain) noexcept;
+
+    float coefficients[kNumStages][BiquadDesign::numCoefficients] {};
+    float integratorCoefficient = 0.0f;   // 1 - exp (-1 / (kIntegrationSeconds * fs))
+    int numChannels = 2;
+    int numVecs = 1;
+
+    // TDF-II state [vec][stage] and the integrators, channels packed into lanes
+    std::array<std::array<Vec, kNumStages>, kMaxVecs> state1 {}, state2 {};
+    std::array<Vec, kMaxVecs> meanSquare {};
+};
+
+template <bool applyGain, typename NextGain>
+void LoudnessMeter::run (const juce::dsp::AudioBlock<float>& block, NextGain&& nextGain) noexcept
+{
+    const auto nChannels = juce::jmin (block.getNumChannels(), static_cast<size_t> (numChannels));
+    const auto nSamples = block.getNumSamples();
+
+    float* channels[kMaxChannels] {};
+    for (size_t ch = 0; ch < nChannels; ++ch)
+        channels[ch] = block.getChannelPointer (ch);
+
+    // Coefficients and state in registers for the whole block
+    Vec c[kNumStages][BiquadDesign::numCoefficients];
+    for (int s = 0; s < kNumStages; ++s)
+        for (int k = 0; k < BiquadDesign::numCoefficients; ++k)
+            c[s][k] = Vec::expand (coefficients[s][k]);
+
+    const auto alpha = Vec::expand (integratorCoefficient);
+    auto s1 = state1;
+    auto s2 = state2;
+    auto ms = meanSquare;
+
+    // One frame of lanes per sample; spare lanes stay at zero
+    alignas (Vec::SIMDRegisterSize) float frame[kMaxVecs * kLanes] {};
+
+    for (size_t i = 0; i < nSamples; ++i)
+    {
+        for (size_t ch = 0; ch < nChannels; ++ch)
+            frame[ch] = channels[ch][i];
+
+        for (int v = 0; v < numVecs; ++v)
+        {
+            auto& st1 = s1[static_cast<size_t> (v)];
+            auto& st2 = s2[static_cast<size_t> (v)];
+            Vec x = Vec::fromRawArray (frame + v * kLanes);
+
+            // Transposed direct form II, as FilterCascade's biquad stages
+            for (size_t s = 0; s < static_cast<size_t> (kNumStages); ++s)
+            {
+                const Vec y = c[s][0] * x + st1[s];
+                st1[s] = c[s][1] * x - c[s][3] * y + st2[s];
+                st2[s] = c[s][2] * x - c[s][4] * y;
+                x = y;
+            }
+
+            auto& m = ms[static_cast<size_t> (v)];
+            m += alpha * (x * x - m);
+        }
+
+        if constexpr (applyGain)
+        {
+            const float gain = nextGain();
+            for (size_t ch = 0; ch < nChannels; ++ch)
+                channels[ch][i] = frame[ch] * gain;
+        }
+    }
+
+    state1 = s1;
+    state2 = s2;
+    meanSquare = ms;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+#include <juce_core/juce_core.h>
+
+/**
+ * Heap memory held by one plugin instance, itemised per owner (a flavor
+ * engine, the chain) and per buffer — for budgeting RAM in large sessions.
+ * Filled on the message thread by EffectsChain::getMemoryReport().
+ */
+struct MemoryReport
+{
+    struct Entry
+    {
+        juce::String owner;     // e.g. "Grape", "HQ Chain / Grape", "Chain"
+        juce::String buffer;    // e.g. "wow/flutter delay"
+        size_t bytes = 0;
+    };
+
+    void add (const juce::String& owner, const juce::String& buffer, size_t bytes)
+    {
+        if (bytes > 0)
+            entries.push_back ({ owner, buffer, bytes });
+    }
+
+    size_t getTotalBytes() const noexcept
+    {
+        size_t total = 0;
+        for (const auto& entry : entries)
+            total += entry.bytes;
+        return total;
+    }
+
+    size_t getTotalBytes (const juce::String& owner) const noexcept
+    {
+        size_t total = 0;
+        for (const auto& entry : entries)
+            if (entry.owner == owner)
+                total += entry.bytes;
+        return total;
+    }
+
+    /** One line per buffer, then the per-owner and overall totals */
+    juce::String toString() const
+    {
+        juce::String text;
+        juce::StringArray owners;
+
+        for (const auto& entry : entries)
+        {
+            text << entry.owner << " / " << entry.buffer << ": " << formatBytes (entry.bytes) << "\n";
+            owners.addIfNotAlreadyThere (entry.owner);
+        }
+
+        for (const auto& owner : owners)
+            text << owner << " total: " << formatBytes (getTotalBytes (owner)) << "\n";
+
+        text << "Total: " << formatBytes (getTotalBytes()) << "\n";
+        return text;
+    }
+
+    std::vector<Entry> entries;
+
+private:
+    static juce::String formatBytes (size_t bytes)
+    {
+        return juce::String (static_cast<double> (bytes) / 1024.0, 1) + " KB";
+    }
+};
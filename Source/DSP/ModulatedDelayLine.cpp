@@ -0,0 +1,126 @@
+#include "ModulatedDelayLine.h"
+
+void ModulatedDelayLine::prepare (int numChannels, int maxDelaySamples)
+{
+    ScratchArena::assertNotOnAudioThread();
+
+    // Lagrange reads up to two samples past the integer delay
+    const int size = juce::nextPowerOfTwo (juce::jmax (maxDelaySamples, 1) + 4);
+
+    buffer.setSize (juce::jmax (1, numChannels), size);
+    allpassState.assign (static_cast<size_t> (buffer.getNumChannels()), 0.0f);
+    mask = size - 1;
+
+    reset();
+}
+
+void ModulatedDelayLine::reset() noexcept
+{
+    buffer.clear();
+    std::fill (allpassState.begin(), allpassState.end(), 0.0f);
+    writePos = 0;
+}
+
+void ModulatedDelayLine::copyChannelState (size_t source, size_t dest) noexcept
+{
+    jassert (source < allpassState.size() && dest < allpassState.size());
+    buffer.copyFrom (static_cast<int> (dest), 0, buffer, static_cast<int> (source), 0, buffer.getNumSamples());
+    allpassState[dest] = allpassState[source];
+}
+
+void ModulatedDelayLine::setInterpolation (Interpolation newInterpolation) noexcept
+{
+    if (newInterpolation == Interpolation::Allpass && interpolation != Interpolation::Allpass)
+        std::fill (allpassState.begin(), allpassState.end(), 0.0f);
+
+    interpolation = newInterpolation;
+}
+
+void ModulatedDelayLine::process (juce::dsp::AudioBlock<float>& block, const float* delaySamples, float mix) noexcept
+{
+    const auto nChannels = juce::jmin (block.getNumChannels(), static_cast<size_t> (buffer.getNumChannels()));
+    const auto nSamples = block.getNumSamples();
+
+    for (size_t ch = 0; ch < nChannels; ++ch)
+    {
+        auto* data = block.getChannelPointer (ch);
+        auto* line = buffer.getWritePointer (static_cast<int> (ch));
+        auto& allpassLast = allpassState[ch];
+
+        switch (interpolation)
+        {
+            case Interpolation::Linear:   processChannel<Interpolation::Linear> (data, nSamples, delaySamples, mix, line, allpassLast); break;
+            case Interpolation::Lagrange: processChannel<Interpolation::Lagrange> (data, nSamples, delaySamples, mix, line, allpassLast); break;
+            case Interpolation::Allpass:  processChannel<Interpolation::Allpass> (data, nSamples, delaySamples, mix, line, allpassLast); break;
+        }
+    }
+
+    writePos = (writePos + static_cast<int> (nSamples)) & mask;
+}
+
+template <ModulatedDelayLine::Interpolation interp>
+void ModulatedDelayLine::processChannel (float* data, size_t numSamples, const float* delaySamples, float mix,
+                                         float* line, float& allpassLast) const noexcept
+{
+    const float maxDelay = getMaxDelaySamples();
+    float last = allpassLast;
+
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        const int wp = (writePos + static_cast<int> (i)) & mask;
+        line[wp] = data[i];
+
+        // Integer part n (newest tap) and fraction f of the delay
+        const float delay = juce::jlimit (1.0f, maxDelay, delaySamples[i]);
+        int n = static_cast<int> (delay);
+        float f = delay - static_cast<float> (n);
+        float delayed;
+
+        if constexpr (interp == Interpolation::Linear)
+        {
+            const float x0 = line[(wp - n) & mask];
+            const float x1 = line[(wp - n - 1) & mask];
+            delayed = x0 + f * (x1 - x0);
+        }
+        else if constexpr (interp == Interpolation::Lagrange)
+        {
+            // Four taps around the read point: n-1 .. n+2, fraction in [1, 2)
+            --n;
+            f += 1.0f;
+            const float x0 = line[(wp - n) & mask];
+            const float x1 = line[(wp - n - 1) & mask];
+            const float x2 = line[(wp - n - 2) & mask];
+            const float x3 = line[(wp - n - 3) & mask];
+
+            const float d1 = f - 1.0f;
+            const float d2 = f - 2.0f;
+            const float d3 = f - 3.0f;
+            const float c0 = -d1 * d2 * d3 * (1.0f / 6.0f);
+            const float c1 = d2 * d3 * 0.5f;
+            const float c2 = -d1 * d3 * 0.5f;
+            const float c3 = d1 * d2 * (1.0f / 6.0f);
+
+            delayed = x0 * c0 + f * (x1 * c1 + x2 * c2 + x3 * c3);
+        }
+        else
+        {
+            // Thiran allpass: keep the fraction in [0.618, 1.618) so the
+            // coefficient stays well inside the unit circle
+            if (f < 0.618f && n >= 1)
+            {
+                --n;
+                f += 1.0f;
+            }
+
+            const float alpha = (1.0f - f) / (1.0f + f);
+            const float x0 = line[(wp - n) & mask];
+            const float x1 = line[(wp - n - 1) & mask];
+            delayed = x1 + alpha * (x0 - last);
+            last = delayed;
+        }
+
+        data[i] += mix * (delayed - data[i]);
+    }
+
+    allpassLast = last;
+}
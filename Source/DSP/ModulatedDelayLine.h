@@ -0,0 +1,62 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "ScratchArena.h"
+
+/**
+ * Multichannel delay line with per-sample modulated, fractional read-out,
+ * for chorus and wow/flutter.
+ * The ring buffer length is a power of two, so wrapping is a bit mask rather
+ * than a modulo. Every channel reads at the same delay curve (supplied per
+ * sample by the caller, typically base delay + ModulationLFO output).
+ * Interpolation is selectable: linear, 3rd-order Lagrange (default — flatter
+ * response, less modulation noise) or 1st-order Thiran allpass (flat
+ * magnitude, best for slow modulation).
+ */
+class ModulatedDelayLine
+{
+public:
+    enum class Interpolation
+    {
+        Linear,
+        Lagrange,
+        Allpass
+    };
+
+    ModulatedDelayLine() = default;
+
+    /** Allocates at least maxDelaySamples (+ interpolation headroom), rounded up to a power of two */
+    void prepare (int numChannels, int maxDelaySamples);
+    void reset() noexcept;
+
+    /** Channel dest's line (and interpolator memory) becomes a copy of channel source's */
+    void copyChannelState (size_t source, size_t dest) noexcept;
+
+    void setInterpolation (Interpolation newInterpolation) noexcept;
+
+    /** Heap held by the ring buffers */
+    size_t getMemoryBytes() const noexcept
+    {
+        return static_cast<size_t> (buffer.getNumChannels() * buffer.getNumSamples()) * sizeof (float)
+             + allpassState.size() * sizeof (float);
+    }
+
+    /** Longest delay process() will honour; longer requests are clamped */
+    float getMaxDelaySamples() const noexcept { return static_cast<float> (mask - 3); }
+
+    /** Writes the block into the line and replaces it with
+     *  dry + mix * (delayed - dry), where the delayed signal is read
+     *  delaySamples[i] samples behind sample i (clamped to 1..getMaxDelaySamples()). */
+    void process (juce::dsp::AudioBlock<float>& block, const float* delaySamples, float mix) noexcept;
+
+private:
+    template <Interpolation interpolation>
+    void processChannel (float* data, size_t numSamples, const float* delaySamples, float mix,
+                         float* line, float& allpassLast) const noexcept;
+
+    juce::AudioBuffer<float> buffer;
+    std::vector<float> allpassState;    // Last output per channel
+    Interpolation interpolation = Interpolation::Lagrange;
+    int mask = 0;
+    int writePos = 0;
+};
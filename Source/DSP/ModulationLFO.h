@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cmath>
+#include <juce_core/juce_core.h>
+
+/**
+ * Low-frequency oscillator for delay modulation (chorus, wow, flutter).
+ * No transcendental calls per sample: the sine is a recursive quadrature
+ * oscillator (one 2x2 rotation per sample, amplitude re-normalised once per
+ * block), the triangle a wrapped phase accumulator. Both start at phase 0
+ * (sine rising from 0, triangle rising from 0), matching sin(phase) and
+ * (2/pi) * asin(sin(phase)).
+ */
+class ModulationLFO
+{
+public:
+    enum class Shape
+    {
+        Sine,
+        Triangle
+    };
+
+    void prepare (Shape newShape, double sampleRate, double frequencyHz) noexcept
+    {
+        shape = newShape;
+        const double w = juce::MathConstants<double>::twoPi * frequencyHz / sampleRate;
+        rotationCos = std::cos (w);
+        rotationSin = std::sin (w);
+        phaseIncrement = frequencyHz / sampleRate;
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        sinState = 0.0;
+        cosState = 1.0;
+        phase = 0.0;
+    }
+
+    /** dest[i] += depth * lfo[i] for the next numSamples samples */
+    void addTo (float* dest, size_t numSamples, float depth) noexcept
+    {
+        if (shape == Shape::Sine)
+        {
+            double s = sinState, c = cosState;
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                dest[i] += depth * static_cast<float> (s);
+                const double sNext = s * rotationCos + c * rotationSin;
+                c = c * rotationCos - s * rotationSin;
+                s = sNext;
+            }
+
+            // Pull the amplitude back to 1 (first-order correction, no sqrt)
+            const double gain = 1.5 - 0.5 * (s * s + c * c);
+            sinState = s * gain;
+            cosState = c * gain;
+        }
+        else
+        {
+            double p = phase;
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                // Triangle in phase with the sine: 0 -> 1 -> 0 -> -1 -> 0
+                double q = p + 0.25;
+                q -= std::floor (q);
+                dest[i] += depth * static_cast<float> (1.0 - 4.0 * std::abs (q - 0.5));
+
+                p += phaseIncrement;
+                if (p >= 1.0)
+                    p -= 1.0;
+            }
+
+            phase = p;
+        }
+    }
+
+private:
+    Shape shape = Shape::Sine;
+
+    // Sine: (sin, cos) of the current phase, rotated by w every sample
+    double sinState = 0.0, cosState = 1.0;
+    double rotationCos = 1.0, rotationSin = 0.0;
+
+    // Triangle: phase in cycles, 0-1
+    double phase = 0.0;
+    double phaseIncrement = 0.0;
+};
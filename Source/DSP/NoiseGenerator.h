@@ -0,0 +1,160 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <juce_core/juce_core.h>
+
+/**
+ * Fast, seedable white noise for Carbonator
+ * kLanes independent xorshift128 generators stored lane by lane (structure of
+ * arrays), so a chunk of kLanes values is a handful of 32-bit shifts and xors
+ * the compiler packs into SIMD registers. Values come out in a fixed order
+ * regardless of how the caller slices its requests (host block size, control
+ * block size), so a given seed/stream always renders the same samples.
+ * Streams are derived from (seed, stream) with splitmix64: one generator per
+ * use (crackle per channel, rumble...) gives uncorrelated, reproducible noise.
+ */
+class NoiseGenerator
+{
+public:
+    static constexpr int kLanes = 8;
+
+    NoiseGenerator() { seed (0, 0); }
+
+    /** Restarts the generator on the given stream — same (seed, stream), same output */
+    void seed (std::uint64_t seedValue, std::uint64_t stream) noexcept
+    {
+        std::uint64_t s = seedValue ^ (stream * 0xd1342543de82ef95ull);
+
+        for (int lane = 0; lane < kLanes; ++lane)
+        {
+            const auto a = splitMix64 (s);
+            const auto b = splitMix64 (s);
+            x[lane] = static_cast<std::uint32_t> (a);
+            y[lane] = static_cast<std::uint32_t> (a >> 32);
+            z[lane] = static_cast<std::uint32_t> (b);
+            w[lane] = static_cast<std::uint32_t> (b >> 32) | 1u;   // Never all-zero
+        }
+
+        cachePos = kLanes;
+    }
+
+    /** Uniform in [0, 1) */
+    float nextFloat() noexcept
+    {
+        if (cachePos == kLanes)
+        {
+            generateChunk (cache.data());
+            cachePos = 0;
+        }
+
+        return cache[static_cast<size_t> (cachePos++)];
+    }
+
+    /** dest[i] = level * uniform [-1, 1) for numSamples samples */
+    void fillBipolar (float* dest, size_t numSamples, float level) noexcept
+    {
+        size_t i = 0;
+
+        // Leftovers of the last chunk first, so the stream never skips values
+        for (; i < numSamples && cachePos < kLanes; ++i)
+            dest[i] = level * (2.0f * cache[static_cast<size_t> (cachePos++)] - 1.0f);
+
+        // Whole chunks straight into dest
+        for (; i + kLanes <= numSamples; i += kLanes)
+        {
+            generateChunk (dest + i);
+            for (int lane = 0; lane < kLanes; ++lane)
+                dest[i + static_cast<size_t> (lane)] = level * (2.0f * dest[i + static_cast<size_t> (lane)] - 1.0f);
+        }
+
+        for (; i < numSamples; ++i)
+            dest[i] = level * (2.0f * nextFloat() - 1.0f);
+    }
+
+private:
+    static std::uint64_t splitMix64 (std::uint64_t& s) noexcept
+    {
+        std::uint64_t r = (s += 0x9e3779b97f4a7c15ull);
+        r = (r ^ (r >> 30)) * 0xbf58476d1ce4e5b9ull;
+        r = (r ^ (r >> 27)) * 0x94d049bb133111ebull;
+        return r ^ (r >> 31);
+    }
+
+    /** One xorshift128 step on every lane, as floats in [0, 1) */
+    void generateChunk (float* dest) noexcept
+    {
+        for (int lane = 0; lane < kLanes; ++lane)
+        {
+            std::uint32_t t = x[lane] ^ (x[lane] << 11);
+            x[lane] = y[lane];
+            y[lane] = z[lane];
+            z[lane] = w[lane];
+            w[lane] = w[lane] ^ (w[lane] >> 19) ^ t ^ (t >> 8);
+
+            // Top 23 bits as the mantissa of a float in [1, 2)
+            const auto bits = (w[lane] >> 9) | 0x3f800000u;
+            float f;
+            std::memcpy (&f, &bits, sizeof (f));
+            dest[lane] = f - 1.0f;
+        }
+    }
+
+    alignas (32) std::uint32_t x[kLanes], y[kLanes], z[kLanes], w[kLanes];
+    alignas (32) std::array<float, kLanes> cache {};
+    int cachePos = kLanes;
+};
+
+/**
+ * Sparse random impulses (vinyl crackle) at an average rate of `probability`
+ * events per sample. The gaps between events are drawn from the geometric
+ * distribution — the discrete Poisson process — so only event samples are
+ * touched; the samples in between are skipped rather than tested one by one.
+ */
+class CrackleGenerator
+{
+public:
+    void seed (std::uint64_t seedValue, std::uint64_t stream) noexcept
+    {
+        noise.seed (seedValue, stream);
+        samplesToNextEvent = -1;
+    }
+
+    /** data[event] += level * uniform [-1, 1) at each event within numSamples */
+    void addTo (float* data, size_t numSamples, float probability, float level) noexcept
+    {
+        if (probability <= 0.0f)
+            return;
+
+        // Gaps drawn at the current rate; a pending gap keeps its draw when the
+        // rate moves (control-rate changes are small)
+        const float logKeep = std::log1p (-juce::jmin (probability, 0.999f));
+
+        if (samplesToNextEvent < 0)
+            samplesToNextEvent = drawGap (logKeep);
+
+        auto pos = static_cast<std::int64_t> (samplesToNextEvent);
+        const auto n = static_cast<std::int64_t> (numSamples);
+
+        while (pos < n)
+        {
+            data[pos] += level * (2.0f * noise.nextFloat() - 1.0f);
+            pos += 1 + drawGap (logKeep);
+        }
+
+        samplesToNextEvent = pos - n;
+    }
+
+private:
+    /** Samples with no event before the next one: P(gap = k) = (1 - p)^k * p */
+    std::int64_t drawGap (float logKeep) noexcept
+    {
+        const float u = 1.0f - noise.nextFloat();   // (0, 1]
+        return static_cast<std::int64_t> (std::log (u) / logKeep);
+    }
+
+    NoiseGenerator noise;
+    std::int64_t samplesToNextEvent = -1;
+};
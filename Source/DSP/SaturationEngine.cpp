@@ -1,105 +1,547 @@
 #include "SaturationEngine.h"
+#include "BiquadDesign.h"
+#include "ScratchArena.h"
+#include <algorithm>
 #include <cmath>
 
-void SaturationEngine::prepare (const juce::dsp::ProcessSpec& spec)
+// =============================================================================
+// Waveshaper kernels — one instantiation per curve / dcBias / mix combination
+// (plus an exact-tanh variant for offline rendering),
+// chosen once per process() call, so the per-sample loops carry no switch and
+// no libm calls and the compiler can vectorise them.
+// =============================================================================
+namespace
 {
-    numChannels = static_cast<int> (spec.numChannels);
+    using CurveType = SaturationEngine::CurveType;
+    using Kernel = void (*) (float*, size_t, const SaturationEngine::Params&);
+
+    template <CurveType curve, bool exact = false>
+    inline float waveshape (float x) noexcept
+    {
+        return SaturationEngine::shapeSample<curve, exact> (x);
+    }
+
+    /** hasMix blends against the kernel's own input — at the oversampled rate
+     *  that input has been through the same up-filter as the wet signal.
+     *  hasBias subtracts the curve's output at the bias alone, so silence in
+     *  gives silence out. */
+    template <CurveType curve, bool hasBias, bool hasMix, bool exact>
+    void shapeBlock (float* data, size_t numSamples, const SaturationEngine::Params& params) noexcept
+    {
+        const float drive = params.drive;
+        const float bias = params.dcBias;
+        const float offset = hasBias ? waveshape<curve, exact> (bias) : 0.0f;
+        const float gain = params.outputGain;
+        const float mix = params.mix;
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            const float in = data[i];
+            float x = in * drive;
+
+            if constexpr (hasBias)
+                x += bias;
+
+            float out = (waveshape<curve, exact> (x) - offset) * gain;
+
+            if constexpr (hasMix)
+                out = in + mix * (out - in);
+
+            data[i] = out;
+        }
+    }
+
+    // ─── First-order ADAA ───────────────────────────────────────
+    // y[n] = (F(x[n]) - F(x[n-1])) / (x[n] - x[n-1]) with F the antiderivative
+    // of the curve: the waveshaper is evaluated as a continuous-time average
+    // over each sample period, which suppresses most aliasing at 1x. Adds a
+    // half-sample group delay, so a partial mix blends against the dry signal
+    // delayed by the same half sample (the mean of this and the last input) —
+    // mixing with the undelayed input would comb-filter the highs.
+    // Done in double — the quotient cancels heavily.
+    using ADAAKernel = void (*) (float*, size_t, const SaturationEngine::Params&, double&, float&);
+
+    /** First antiderivative of each curve (constant offsets dropped — only
+     *  differences are ever used). */
+    template <CurveType curve>
+    inline double antiderivative (double x) noexcept
+    {
+        const double ax = std::abs (x);
+
+        if constexpr (curve == CurveType::Tanh)
+        {
+            // log(cosh(x)) + log(2), written so exp() cannot overflow
+            return ax + std::log1p (std::exp (-2.0 * ax));
+        }
+        else if constexpr (curve == CurveType::WarmClip)
+        {
+            const double x2 = x * x;
+            return ax <= 1.0 ? 0.75 * x2 - 0.125 * x2 * x2
+                             : ax - 0.375;
+        }
+        else
+        {
+            return ax - std::log1p (ax);
+        }
+    }
+
+    template <CurveType curve, bool hasBias, bool hasMix>
+    void shapeBlockADAA (float* data, size_t numSamples, const SaturationEngine::Params& params,
+                         double& lastInput, float& lastDry) noexcept
+    {
+        constexpr double illConditioned = 1.0e-5;
+
+        const double drive = params.drive;
+        const double bias = params.dcBias;
+        const float offset = hasBias ? waveshape<curve> (params.dcBias) : 0.0f;   // As shapeBlock
+        const float gain = params.outputGain;
+        const float mix = params.mix;
+
+        double x1 = lastInput;
+        double ad1 = antiderivative<curve> (x1);   // curve may differ from the last call
+        float dry1 = lastDry;
+        const float blockLastDry = numSamples > 0 ? data[numSamples - 1] : lastDry;
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            const float in = data[i];
+            double x = in * drive;
+
+            if constexpr (hasBias)
+                x += bias;
+
+            const double ad = antiderivative<curve> (x);
+            const double dx = x - x1;
+
+            const float shaped = std::abs (dx) > illConditioned
+                                   ? static_cast<float> ((ad - ad1) / dx)
+                                   : waveshape<curve> (static_cast<float> (0.5 * (x + x1)));
+
+            float out = (shaped - offset) * gain;
+
+            if constexpr (hasMix)
+            {
+                const float dry = 0.5f * (in + dry1);
+                out = dry + mix * (out - dry);
+                dry1 = in;
+            }
+
+            data[i] = out;
+            x1 = x;
+            ad1 = ad;
+        }
+
+        lastInput = x1;
+        lastDry = blockLastDry;
+    }
+
+    template <CurveType curve>
+    ADAAKernel selectADAAKernel (bool hasBias, bool hasMix) noexcept
+    {
+        if (hasBias)
+            return hasMix ? shapeBlockADAA<curve, true, true> : shapeBlockADAA<curve, true, false>;
+
+        return hasMix ? shapeBlockADAA<curve, false, true> : shapeBlockADAA<curve, false, false>;
+    }
+
+    ADAAKernel selectADAAKernel (CurveType curve, bool hasBias, bool hasMix) noexcept
+    {
+        switch (curve)
+        {
+            case CurveType::SoftClip:     return selectADAAKernel<CurveType::SoftClip> (hasBias, hasMix);
+            case CurveType::Tanh:         return selectADAAKernel<CurveType::Tanh> (hasBias, hasMix);
+            case CurveType::AsymSoftClip: return selectADAAKernel<CurveType::AsymSoftClip> (hasBias, hasMix);
+            case CurveType::WarmClip:     return selectADAAKernel<CurveType::WarmClip> (hasBias, hasMix);
+        }
+        return selectADAAKernel<CurveType::SoftClip> (hasBias, hasMix);
+    }
 
-    // 4x oversampling (2 stages) with polyphase IIR half-band filters
-    oversampling = std::make_unique<juce::dsp::Oversampling<float>> (
-        spec.numChannels, 2,
-        juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR);
+    /** TDF-II biquad over one channel — c = { b0, b1, b2, a1, a2 } */
+    void filterBlock (float* data, size_t numSamples, const float* c, float* state) noexcept
+    {
+        float s1 = state[0];
+        float s2 = state[1];
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            const float in = data[i];
+            const float out = c[0] * in + s1;
+            s1 = c[1] * in - c[3] * out + s2;
+            s2 = c[2] * in - c[4] * out;
+            data[i] = out;
+        }
 
-    oversampling->initProcessing (spec.maximumBlockSize);
+        state[0] = s1;
+        state[1] = s2;
+    }
 
-    dryBuffer.setSize (numChannels, static_cast<int> (spec.maximumBlockSize));
+    template <CurveType curve, bool exact = false>
+    Kernel selectKernel (bool hasBias, bool hasMix) noexcept
+    {
+        if (hasBias)
+            return hasMix ? shapeBlock<curve, true, true, exact> : shapeBlock<curve, true, false, exact>;
+
+        return hasMix ? shapeBlock<curve, false, true, exact> : shapeBlock<curve, false, false, exact>;
+    }
+
+    /** exactTanh only changes the Tanh curve — the others are already exact */
+    Kernel selectKernel (CurveType curve, bool hasBias, bool hasMix, bool exactTanh) noexcept
+    {
+        switch (curve)
+        {
+            case CurveType::SoftClip:     return selectKernel<CurveType::SoftClip> (hasBias, hasMix);
+            case CurveType::Tanh:         return exactTanh ? selectKernel<CurveType::Tanh, true> (hasBias, hasMix)
+                                                           : selectKernel<CurveType::Tanh> (hasBias, hasMix);
+            case CurveType::AsymSoftClip: return selectKernel<CurveType::AsymSoftClip> (hasBias, hasMix);
+            case CurveType::WarmClip:     return selectKernel<CurveType::WarmClip> (hasBias, hasMix);
+        }
+        return selectKernel<CurveType::SoftClip> (hasBias, hasMix);
+    }
 }
 
-void SaturationEngine::process (juce::dsp::AudioBlock<float>& block, const Params& params)
+void SaturationEngine::prepare (const juce::dsp::ProcessSpec& spec)
 {
-    const auto nChannels = block.getNumChannels();
-    const auto nSamples = block.getNumSamples();
+    ScratchArena::assertNotOnAudioThread();
+
+    numChannels = static_cast<int> (spec.numChannels);
+    sampleRate = spec.sampleRate;
+    maximumBlockSize = static_cast<size_t> (spec.maximumBlockSize);
+
+    // The selected variant only: each is a filter design plus up to 16x buffers
+    activeVariant = getVariantIndex (oversamplingStages, oversamplingFilter);
 
-    // Save dry signal if parallel mix needed
-    const bool needsDryMix = params.mix < 0.999f;
-    if (needsDryMix)
+    for (int variant = 0; variant < kNumVariants; ++variant)
     {
-        for (size_t ch = 0; ch < nChannels; ++ch)
-            dryBuffer.copyFrom (static_cast<int> (ch), 0,
-                                block.getChannelPointer (ch),
-                                static_cast<int> (nSamples));
+        if (variant == activeVariant)
+            createOversampler (variant);
+        else
+            oversamplers[static_cast<size_t> (variant)].reset();
     }
 
-    // Lambda for the inner saturation loop
-    auto processBlock = [&] (juce::dsp::AudioBlock<float>& audioBlock)
+    oversampling = oversamplers[static_cast<size_t> (activeVariant)].get();
+    variantState.store (VariantState::Current, std::memory_order_release);
+
+    const auto numSlots = static_cast<size_t> (kMaxChainStages * numChannels);
+    adaaLastInput.assign (numSlots, 0.0);
+    adaaLastDry.assign (numSlots, 0.0f);
+    chainFilterState.assign (numSlots * 2, 0.0f);
+    chainFilterDesigns.fill ({});
+}
+
+void SaturationEngine::createOversampler (int variant)
+{
+    ScratchArena::assertNotOnAudioThread();
+
+    const auto filterType = variant / kMaxOversamplingStages == static_cast<int> (OversamplingFilter::LinearPhaseFIR)
+                              ? juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple
+                              : juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR;
+    const auto numStages = static_cast<size_t> (variant % kMaxOversamplingStages + 1);
+
+    auto& os = oversamplers[static_cast<size_t> (variant)];
+    os = std::make_unique<juce::dsp::Oversampling<float>> (static_cast<size_t> (numChannels), numStages, filterType);
+    os->initProcessing (maximumBlockSize);
+}
+
+size_t SaturationEngine::getOversamplingBytes (int numStages, OversamplingFilter filter,
+                                               size_t channels, size_t blockSize) noexcept
+{
+    // juce::dsp::Oversampling's (max quality) stage n designs its half-bands
+    // for a transition width of 0.05 (first stage) or 0.1, and n * 10 dB more
+    // stopband attenuation than the first stage's 90 dB up / 70 dB down (75 /
+    // 70 for IIR). FIR taps from Kaiser's estimate, each with a coefficient
+    // and a sample of state per channel (the down filter keeps a second,
+    // quarter-length state). Polyphase IIR half-bands need roughly one
+    // allpass coefficient, and per channel one state value, per 10 dB.
+    size_t bytes = 0;
+
+    for (int stage = 0; stage < numStages; ++stage)
     {
-        const auto numSamples = audioBlock.getNumSamples();
-        for (size_t ch = 0; ch < nChannels; ++ch)
+        bytes += (static_cast<size_t> (2) << stage) * blockSize * channels * sizeof (float);
+
+        const double transitionWidth = stage == 0 ? 0.05 : 0.1;
+        const double upAttenuation = (filter == OversamplingFilter::LinearPhaseFIR ? 90.0 : 75.0) + 10.0 * stage;
+        const double downAttenuation = 70.0 + 10.0 * stage;
+
+        for (const double attenuation : { upAttenuation, downAttenuation })
         {
-            auto* data = audioBlock.getChannelPointer (ch);
-            for (size_t i = 0; i < numSamples; ++i)
+            if (filter == OversamplingFilter::LinearPhaseFIR)
+            {
+                const auto taps = static_cast<size_t> (std::ceil ((attenuation - 7.95) / (14.36 * transitionWidth))) + 1;
+                bytes += taps * (1 + channels) * sizeof (float);
+            }
+            else
             {
-                float sample = data[i] * params.drive + params.dcBias;
-                sample = applyWaveshaper (sample, params.curve);
-                data[i] = sample * params.outputGain;
+                const auto coefficients = static_cast<size_t> (std::ceil (attenuation / 10.0));
+                bytes += coefficients * (1 + channels) * sizeof (float);
             }
         }
-    };
 
-    if (oversamplingEnabled && oversampling != nullptr)
+        if (filter == OversamplingFilter::LinearPhaseFIR)
+        {
+            const auto downTaps = static_cast<size_t> (std::ceil ((downAttenuation - 7.95) / (14.36 * transitionWidth))) + 1;
+            bytes += (downTaps / 4 + 1) * channels * sizeof (float);
+        }
+    }
+
+    return bytes;
+}
+
+size_t SaturationEngine::getMemoryBytes() const noexcept
+{
+    size_t bytes = adaaLastInput.size() * sizeof (double)
+                 + (adaaLastDry.size() + chainFilterState.size()) * sizeof (float);
+
+    for (int variant = 0; variant < kNumVariants; ++variant)
+        if (oversamplers[static_cast<size_t> (variant)] != nullptr)
+            bytes += sizeof (juce::dsp::Oversampling<float>)
+                   + getOversamplingBytes (variant % kMaxOversamplingStages + 1,
+                                           static_cast<OversamplingFilter> (variant / kMaxOversamplingStages),
+                                           static_cast<size_t> (numChannels), maximumBlockSize);
+
+    return bytes;
+}
+
+void SaturationEngine::setOversampling (int numStages, OversamplingFilter filter)
+{
+    numStages = juce::jlimit (1, kMaxOversamplingStages, numStages);
+
+    if (numStages == oversamplingStages && filter == oversamplingFilter)
+        return;
+
+    oversamplingStages = numStages;
+    oversamplingFilter = filter;
+    updateOversampler();
+}
+
+bool SaturationEngine::updateOversampler() noexcept
+{
+    // Not prepared yet: prepare() builds the selected variant
+    if (activeVariant < 0)
+        return true;
+
+    const int wanted = getVariantIndex (oversamplingStages, oversamplingFilter);
+
+    // The preparation thread owns the array: back at the next processChain()
+    if (variantState.load (std::memory_order_acquire) == VariantState::Requested)
+        return wanted == activeVariant;
+
+    bool retiredVariant = false;
+
+    if (wanted != activeVariant && oversamplers[static_cast<size_t> (wanted)] != nullptr)
     {
-        auto oversampledBlock = oversampling->processSamplesUp (block);
-        processBlock (oversampledBlock);
-        oversampling->processSamplesDown (block);
+        // The incoming variant last ran who knows when: start it from silence
+        oversampling = oversamplers[static_cast<size_t> (wanted)].get();
+        oversampling->reset();
+        activeVariant = wanted;
+        retiredVariant = true;
+    }
+
+    if (wanted != activeVariant || retiredVariant)
+    {
+        requestedVariant = wanted;
+        variantState.store (VariantState::Requested, std::memory_order_release);
     }
     else
     {
-        processBlock (block);
+        variantState.store (VariantState::Current, std::memory_order_relaxed);
     }
 
-    // Parallel dry/wet mix
-    if (needsDryMix)
+    return wanted == activeVariant;
+}
+
+void SaturationEngine::buildRequestedOversampler()
+{
+    if (variantState.load (std::memory_order_acquire) != VariantState::Requested)
+        return;
+
+    // The audio thread only touches activeVariant's oversampler until Built
+    for (int variant = 0; variant < kNumVariants; ++variant)
     {
-        for (size_t ch = 0; ch < nChannels; ++ch)
+        auto& os = oversamplers[static_cast<size_t> (variant)];
+
+        if (variant == requestedVariant)
+        {
+            if (os == nullptr)
+                createOversampler (variant);
+        }
+        else if (variant != activeVariant)
         {
-            auto* wetData = block.getChannelPointer (ch);
-            const auto* dryData = dryBuffer.getReadPointer (static_cast<int> (ch));
-            for (size_t i = 0; i < nSamples; ++i)
-                wetData[i] = dryData[i] * (1.0f - params.mix) + wetData[i] * params.mix;
+            os.reset();
         }
     }
+
+    variantState.store (VariantState::Built, std::memory_order_release);
 }
 
-void SaturationEngine::reset()
+void SaturationEngine::setAntiAliasing (AntiAliasing newMode)
 {
-    if (oversampling != nullptr)
+    if (newMode == antiAliasing)
+        return;
+
+    // Entering ADAA: don't difference against a sample from long ago
+    if (newMode == AntiAliasing::Antiderivative)
+    {
+        std::fill (adaaLastInput.begin(), adaaLastInput.end(), 0.0);
+        std::fill (adaaLastDry.begin(), adaaLastDry.end(), 0.0f);
+    }
+
+    // Entering oversampling: its half-bands still hold whatever ran through
+    // them before the switch away
+    if (newMode == AntiAliasing::Oversampling && oversampling != nullptr)
         oversampling->reset();
+
+    antiAliasing = newMode;
 }
 
-float SaturationEngine::getLatencyInSamples() const
+void SaturationEngine::process (juce::dsp::AudioBlock<float>& block, const Params& params)
 {
-    if (oversamplingEnabled && oversampling != nullptr)
-        return oversampling->getLatencyInSamples();
-    return 0.0f;
+    const Stage stage { params, {} };
+    processChain (block, &stage, 1);
+}
+
+void SaturationEngine::processChain (juce::dsp::AudioBlock<float>& block, const Stage* stages, size_t numStages)
+{
+    jassert (numStages <= static_cast<size_t> (kMaxChainStages));
+    numStages = juce::jmin (numStages, static_cast<size_t> (kMaxChainStages));
+
+    // A variant switch was waiting for the preparation thread
+    if (variantState.load (std::memory_order_relaxed) == VariantState::Built)
+        updateOversampler();
+
+    if (antiAliasing == AntiAliasing::Oversampling && oversampling != nullptr)
+    {
+        // One round-trip for the whole chain; stage mixes blend against the
+        // upsampled signal, so dry and wet share the resampling latency
+        // (only the channels passed in: the dual-mono path passes one)
+        auto oversampledBlock = oversampling->processSamplesUp (block).getSubsetChannelBlock (0, block.getNumChannels());
+        runStages (oversampledBlock, stages, numStages,
+                   sampleRate * static_cast<double> (oversampling->getOversamplingFactor()), false);
+        oversampling->processSamplesDown (block);
+    }
+    else
+    {
+        const bool useADAA = antiAliasing == AntiAliasing::Antiderivative;
+        runStages (block, stages, numStages, sampleRate, useADAA);
+    }
 }
 
-float SaturationEngine::applyWaveshaper (float sample, CurveType curve)
+void SaturationEngine::runStages (juce::dsp::AudioBlock<float>& block, const Stage* stages, size_t numStages,
+                                  double processingRate, bool useADAA)
 {
-    switch (curve)
+    const auto nChannels = juce::jmin (block.getNumChannels(), static_cast<size_t> (numChannels));
+    const auto nSamples = block.getNumSamples();
+
+    for (size_t s = 0; s < numStages; ++s)
     {
-        case CurveType::SoftClip:
-        case CurveType::AsymSoftClip:
-            // x/(1+|x|) — AsymSoftClip gets its asymmetry from the dcBias applied before
-            return sample / (1.0f + std::abs (sample));
+        const auto& shaper = stages[s].shaper;
+        const bool hasBias = shaper.dcBias != 0.0f;
+        const bool hasMix = shaper.mix < 0.999f;
+        const size_t slot = s * static_cast<size_t> (numChannels);
+
+        if (useADAA)
+        {
+            const auto kernel = selectADAAKernel (shaper.curve, hasBias, hasMix);
 
-        case CurveType::Tanh:
-            return std::tanh (sample);
+            for (size_t ch = 0; ch < nChannels; ++ch)
+                kernel (block.getChannelPointer (ch), nSamples, shaper, adaaLastInput[slot + ch], adaaLastDry[slot + ch]);
+        }
+        else
+        {
+            const auto kernel = selectKernel (shaper.curve, hasBias, hasMix, exactTanh);
+
+            for (size_t ch = 0; ch < nChannels; ++ch)
+                kernel (block.getChannelPointer (ch), nSamples, shaper);
+        }
 
-        case CurveType::WarmClip:
+        if (stages[s].filter.type != ChainFilter::Type::None)
         {
-            float clamped = juce::jlimit (-1.0f, 1.0f, sample);
-            return 1.5f * clamped - 0.5f * clamped * clamped * clamped;
+            const float* coeffs = getChainFilterCoefficients (s, stages[s].filter, processingRate);
+
+            for (size_t ch = 0; ch < nChannels; ++ch)
+                filterBlock (block.getChannelPointer (ch), nSamples, coeffs,
+                             chainFilterState.data() + (slot + ch) * 2);
         }
     }
-    return sample;
+}
+
+const float* SaturationEngine::getChainFilterCoefficients (size_t stage, const ChainFilter& filter, double rate)
+{
+    auto& design = chainFilterDesigns[stage];
+
+    if (design.type == filter.type && design.frequency == filter.frequency
+        && design.q == filter.q && design.rate == rate)
+        return design.coeffs;
+
+    // State from a different rate (or a different filter) is meaningless
+    if (design.rate != rate || design.type != filter.type)
+        std::fill_n (chainFilterState.begin() + static_cast<std::ptrdiff_t> (stage * static_cast<size_t> (numChannels) * 2),
+                     numChannels * 2, 0.0f);
+
+    design.type = filter.type;
+    design.frequency = filter.frequency;
+    design.q = filter.q;
+    design.rate = rate;
+
+    switch (filter.type)
+    {
+        case ChainFilter::Type::DCBlock:
+        {
+            // Bilinear 1st-order high-pass
+            const double k = std::tan (juce::MathConstants<double>::pi * filter.frequency / rate);
+            BiquadDesign::store (design.coeffs, 1.0, -1.0, 0.0, 1.0 + k, k - 1.0, 0.0);
+            break;
+        }
+        case ChainFilter::Type::LowPass:  BiquadDesign::lowPass (design.coeffs, rate, filter.frequency, filter.q); break;
+        case ChainFilter::Type::HighPass: BiquadDesign::highPass (design.coeffs, rate, filter.frequency, filter.q); break;
+        case ChainFilter::Type::None:     BiquadDesign::store (design.coeffs, 1.0, 0.0, 0.0, 1.0, 0.0, 0.0); break;
+    }
+
+    return design.coeffs;
+}
+
+void SaturationEngine::reset()
+{
+    // Other variants are reset when they are switched in
+    if (oversampling != nullptr)
+        oversampling->reset();
+
+    std::fill (adaaLastInput.begin(), adaaLastInput.end(), 0.0);
+    std::fill (adaaLastDry.begin(), adaaLastDry.end(), 0.0f);
+    std::fill (chainFilterState.begin(), chainFilterState.end(), 0.0f);
+}
+
+void SaturationEngine::copyChannelState (size_t source, size_t dest) noexcept
+{
+    const auto channels = static_cast<size_t> (numChannels);
+    jassert (source < channels && dest < channels);
+
+    for (size_t s = 0; s < static_cast<size_t> (kMaxChainStages); ++s)
+    {
+        const auto slot = s * channels;
+        adaaLastInput[slot + dest] = adaaLastInput[slot + source];
+        adaaLastDry[slot + dest] = adaaLastDry[slot + source];
+        chainFilterState[(slot + dest) * 2]     = chainFilterState[(slot + source) * 2];
+        chainFilterState[(slot + dest) * 2 + 1] = chainFilterState[(slot + source) * 2 + 1];
+    }
+}
+
+float SaturationEngine::getLatencyInSamples (size_t numStages) const
+{
+    if (antiAliasing == AntiAliasing::Oversampling && oversampling != nullptr)
+        return oversampling->getLatencyInSamples();
+
+    // Chained ADAA stages each add their half sample
+    if (antiAliasing == AntiAliasing::Antiderivative)
+        return kADAALatency * static_cast<float> (numStages);
+
+    return 0.0f;
+}
+
+float SaturationEngine::getMaxLatencyInSamples()
+{
+    // FIR half-bands are longer than IIR ones, and every stage adds to the total
+    static const float maxLatency = juce::dsp::Oversampling<float> (1, static_cast<size_t> (kMaxOversamplingStages),
+                                                                    juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple)
+                                        .getLatencyInSamples();
+    return maxLatency;
 }
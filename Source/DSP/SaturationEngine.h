@@ -1,11 +1,24 @@
 #pragma once
 
 #include <juce_dsp/juce_dsp.h>
+#include <atomic>
 
 /**
  * Shared oversampled saturation engine for Carbonator v2.0
  * Wraps juce::dsp::Oversampling with configurable transfer functions.
- * 4x oversampling with polyphase IIR half-band filters.
+ * 2x-16x oversampling with minimum-phase IIR or linear-phase FIR half-bands.
+ * Only the selected factor/filter variant is built; selecting another asks
+ * the owner's preparation thread to build it (buildRequestedOversampler())
+ * while the current one keeps running, so the audio thread never allocates.
+ * A chain of waveshapers (with short filters between them) can run inside a
+ * single up/down pair — several saturators, one resampling round-trip.
+ * Alternatively runs at 1x with first-order antiderivative anti-aliasing
+ * (ADAA): no resampling, half a sample of latency per waveshaper, most of
+ * the aliasing suppressed.
+ * The waveshaping loops are compile-time specialised per curve and per
+ * dcBias/mix usage (see SaturationEngine.cpp) so they run branch-free and
+ * vectorise; Tanh uses a rational approximation (|error| < 1e-4) unless
+ * exact tanh is requested (offline rendering).
  */
 class SaturationEngine
 {
@@ -13,37 +26,233 @@ public:
     enum class CurveType
     {
         SoftClip,       // x/(1+|x|) — warm, even harmonics
-        Tanh,           // std::tanh(x) — tube-like, odd harmonics
+        Tanh,           // tanh(x) — tube-like, odd harmonics
         AsymSoftClip,   // x/(1+|x|) with DC bias applied before — even harmonics via asymmetry
         WarmClip        // Cubic 1.5x - 0.5x^3 clamped — gentlest curve
     };
 
+    enum class AntiAliasing
+    {
+        None,           // 1x, plain waveshaping — cheapest, fully aliased
+        Oversampling,   // 2x-16x up/down around the waveshaper (see setOversampling)
+        Antiderivative  // 1x first-order ADAA — no resampling, 0.5 samples latency per stage
+    };
+
+    enum class OversamplingFilter
+    {
+        MinimumPhaseIIR,    // Polyphase IIR half-bands — low, fractional latency
+        LinearPhaseFIR      // Equiripple FIR half-bands — linear phase, more latency
+    };
+
+    static constexpr int kMaxOversamplingStages = 4;   // 2^4 = 16x
+
+    /** Group delay of one first-order ADAA waveshaper */
+    static constexpr float kADAALatency = 0.5f;
+
     struct Params
     {
         CurveType curve  = CurveType::SoftClip;
         float drive      = 1.0f;
-        float dcBias     = 0.0f;    // Applied after drive, before waveshaping
+        float dcBias     = 0.0f;    // Applied after drive, before waveshaping; the curve's
+                                    // output at the bias alone is subtracted again, so
+                                    // silence stays silent and only the signal's
+                                    // asymmetry is left for DC blockers to remove
         float outputGain = 1.0f;
         float mix        = 1.0f;    // 1.0 = fully wet, 0.0 = fully dry
     };
 
+    /** Short filter run after a chain stage's waveshaper, at the processing
+     *  (oversampled) rate. Designed in the engine, so callers never need to
+     *  know the current oversampling factor. */
+    struct ChainFilter
+    {
+        enum class Type
+        {
+            None,
+            DCBlock,    // 1st-order high-pass
+            LowPass,    // RBJ 2nd-order
+            HighPass    // RBJ 2nd-order
+        };
+
+        Type type       = Type::None;
+        float frequency = 5.0f;
+        float q         = 0.707f;  // LowPass/HighPass only
+    };
+
+    struct Stage
+    {
+        Params shaper;
+        ChainFilter filter;
+    };
+
+    static constexpr int kMaxChainStages = 4;
+
     SaturationEngine() = default;
 
     void prepare (const juce::dsp::ProcessSpec& spec);
     void process (juce::dsp::AudioBlock<float>& block, const Params& params);
+
+    /** Runs stages[0..numStages) in order inside one up/down pair (or at 1x
+     *  in the None/Antiderivative modes). Each stage's mix blends against
+     *  that stage's own input. At most kMaxChainStages stages. */
+    void processChain (juce::dsp::AudioBlock<float>& block, const Stage* stages, size_t numStages);
+
+    template <size_t numStages>
+    void processChain (juce::dsp::AudioBlock<float>& block, const Stage (&stages)[numStages])
+    {
+        static_assert (numStages <= kMaxChainStages, "Too many chain stages");
+        processChain (block, stages, numStages);
+    }
+
     void reset();
 
-    void setOversamplingEnabled (bool enabled) { oversamplingEnabled = enabled; }
-    bool isOversamplingEnabled() const { return oversamplingEnabled; }
-    float getLatencyInSamples() const;
+    /** Channel dest's ADAA and chain-filter memory becomes a copy of channel
+     *  source's. The oversamplers' half-band state is internal to
+     *  juce::dsp::Oversampling and can't be copied; it catches up within the
+     *  filters' length. */
+    void copyChannelState (size_t source, size_t dest) noexcept;
+
+    /** Audio-thread safe. The mode being entered starts from clear state
+     *  (ADAA history, or the active oversampler's filters). */
+    void setAntiAliasing (AntiAliasing newMode);
+    AntiAliasing getAntiAliasing() const { return antiAliasing; }
+
+    /** Oversampling variant used in AntiAliasing::Oversampling mode.
+     *  numStages 1-4 = 2x/4x/8x/16x. Audio-thread safe: a variant that isn't
+     *  built yet is requested from buildRequestedOversampler(), and the
+     *  previous one keeps running until it's ready. The incoming variant
+     *  starts from clear filter state. */
+    void setOversampling (int numStages, OversamplingFilter filter);
+
+    /** Preparation thread, never concurrently with prepare(): builds the
+     *  variant setOversampling() asked for and frees the ones no longer used */
+    void buildRequestedOversampler();
+
+    /** Audio thread: switches to the selected variant if it has been built
+     *  (processChain() does so too), otherwise asks the preparation thread
+     *  for it. True once the selected variant is the one running. */
+    bool updateOversampler() noexcept;
+
+    /** std::tanh instead of the rational approximation (Tanh curve only).
+     *  Costs a libm call per sample — meant for offline rendering. */
+    void setExactTanh (bool shouldBeExact) { exactTanh = shouldBeExact; }
+
+    bool isExactTanh() const { return exactTanh; }
+
+    /** Oversampling: the running variant's latency. Antiderivative: half a
+     *  sample per waveshaper of a numStages-stage processChain() — the caller
+     *  says how many it chains, so the figure never depends on what ran last. */
+    float getLatencyInSamples (size_t numStages = 1) const;
+
+    /** Latency of the slowest variant setOversampling() can select (16x
+     *  linear-phase FIR) — the bound a constant-latency host report needs.
+     *  Depends only on the filter designs, so it's computed once. */
+    static float getMaxLatencyInSamples();
+
+    /** Heap held by the built oversampler variants and per-channel state.
+     *  juce::dsp::Oversampling doesn't report its allocation, so that part is
+     *  estimated (see getOversamplingBytes()). Not from the audio thread, and
+     *  not concurrently with buildRequestedOversampler(). */
+    size_t getMemoryBytes() const noexcept;
+
+    /** Estimated heap of a juce::dsp::Oversampling with numStages stages:
+     *  each stage's buffer at its rate, plus its half-bands' coefficients and
+     *  per-channel state, sized from the designs JUCE picks for that stage */
+    static size_t getOversamplingBytes (int numStages, OversamplingFilter filter,
+                                        size_t numChannels, size_t maximumBlockSize) noexcept;
+
+    /** One sample through a transfer curve (no drive/bias/gain) — the maths
+     *  behind every kernel, for fused per-flavor loops running at the base rate. */
+    template <CurveType curve, bool exact = false>
+    static float shapeSample (float x) noexcept
+    {
+        if constexpr (curve == CurveType::Tanh)
+        {
+            if constexpr (exact)
+                return std::tanh (x);
+            else
+                return fastTanh (x);
+        }
+        else if constexpr (curve == CurveType::WarmClip)
+        {
+            const float clamped = std::min (std::max (x, -1.0f), 1.0f);
+            return 1.5f * clamped - 0.5f * clamped * clamped * clamped;
+        }
+        else
+        {
+            // x/(1+|x|) — AsymSoftClip gets its asymmetry from the dcBias applied before
+            return x / (1.0f + std::abs (x));
+        }
+    }
 
 private:
-    static float applyWaveshaper (float sample, CurveType curve);
+    /** Padé [7/6] tanh. Monotonic and below 1 up to the clamp point, so
+     *  |error| < 1e-4 over the whole real line. */
+    static float fastTanh (float x) noexcept
+    {
+        x = std::min (std::max (x, -4.97f), 4.97f);
+        const float x2 = x * x;
+        const float num = x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2)));
+        const float den = 135135.0f + x2 * (62370.0f + x2 * (3150.0f + x2 * 28.0f));
+        return num / den;
+    }
+
+    static constexpr int kNumFilterTypes = 2;
+    static constexpr int kNumVariants = kNumFilterTypes * kMaxOversamplingStages;
 
-    std::unique_ptr<juce::dsp::Oversampling<float>> oversampling;
-    bool oversamplingEnabled = true;
+    /** Who owns the oversamplers array (see buildRequestedOversampler()) */
+    enum class VariantState
+    {
+        Current,        // Running variant is the selected one; audio thread
+        Requested,      // Preparation thread builds requestedVariant and frees
+                        // the unused ones — the audio thread keeps only activeVariant
+        Built           // Audio thread again: switches at its next updateOversampler()
+    };
+
+    static int getVariantIndex (int numStages, OversamplingFilter filter) noexcept
+    {
+        return static_cast<int> (filter) * kMaxOversamplingStages + numStages - 1;
+    }
+
+    /** Builds the variant (not the audio thread) */
+    void createOversampler (int variant);
+
+    /** Chain filter coefficients for one stage slot, redesigned only when the
+     *  filter settings or the processing rate change. */
+    struct ChainFilterDesign
+    {
+        ChainFilter::Type type = ChainFilter::Type::None;
+        float frequency = 0.0f;
+        float q = 0.0f;
+        double rate = 0.0;
+        float coeffs[5] = { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    };
+
+    void runStages (juce::dsp::AudioBlock<float>& block, const Stage* stages, size_t numStages,
+                    double processingRate, bool useADAA);
+    const float* getChainFilterCoefficients (size_t stage, const ChainFilter& filter, double rate);
+
+    // [filter][numStages - 1]: the running variant, and while a switch is
+    // pending the one being built
+    std::array<std::unique_ptr<juce::dsp::Oversampling<float>>, kNumVariants> oversamplers;
+    juce::dsp::Oversampling<float>* oversampling = nullptr;   // Running variant
+    int activeVariant = -1;                                   // Its index; -1 until prepare()
+    int requestedVariant = -1;                                // Published with Requested
+    std::atomic<VariantState> variantState { VariantState::Current };
+    int oversamplingStages = 2;                               // Selected variant
+    OversamplingFilter oversamplingFilter = OversamplingFilter::MinimumPhaseIIR;
+    AntiAliasing antiAliasing = AntiAliasing::Oversampling;
+    bool exactTanh = false;
     int numChannels = 2;
+    double sampleRate = 44100.0;
+    size_t maximumBlockSize = 0;
+
+    // ADAA: previous (driven, biased) waveshaper input and previous dry
+    // sample (for the half-sample-delayed mix), [stage][channel]
+    std::vector<double> adaaLastInput;
+    std::vector<float> adaaLastDry;
 
-    // Dry buffer for parallel mix
-    juce::AudioBuffer<float> dryBuffer;
+    // Chain filters: TDF-II state [stage][channel][2] and per-stage designs
+    std::vector<float> chainFilterState;
+    std::array<ChainFilterDesign, kMaxChainStages> chainFilterDesigns;
 };
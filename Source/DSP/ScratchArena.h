@@ -0,0 +1,142 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+/**
+ * Per-instance scratch memory for Carbonator's temporary buffers
+ * One allocation, sized in prepare() for the worst case, from which stages
+ * take cache-line aligned slices while processing (transition and blend
+ * buffers, filter interleave frames, crossover bands...). Slices are handed
+ * out stack-wise and released when the enclosing Scope closes, so every stage
+ * reuses the same few hot cache lines instead of owning a buffer of its own.
+ *
+ * Buffers are only ever sized in prepare(): in debug builds, code running
+ * inside an AudioThreadScope that tries to (re)size one asserts.
+ */
+class ScratchArena
+{
+public:
+    static constexpr size_t kAlignment = 64;   // Cache line
+
+    ScratchArena() = default;
+
+    /** Arena bytes taken by a slice of numFloats floats */
+    static constexpr size_t getSliceBytes (size_t numFloats) noexcept
+    {
+        return alignUp (numFloats * sizeof (float));
+    }
+
+    /** Arena bytes taken by allocateBlock (numChannels, numSamples) */
+    static constexpr size_t getBlockBytes (size_t numChannels, size_t numSamples) noexcept
+    {
+        return alignUp (numChannels * sizeof (float*)) + numChannels * getSliceBytes (numSamples);
+    }
+
+    /** Allocates numBytes of scratch; everything previously handed out is invalidated */
+    void prepare (size_t numBytes)
+    {
+        assertNotOnAudioThread();
+
+        storage.allocate (numBytes + kAlignment, false);
+        const auto address = reinterpret_cast<juce::pointer_sized_uint> (storage.get());
+        base = storage.get() + (alignUp (static_cast<size_t> (address)) - static_cast<size_t> (address));
+        capacity = numBytes;
+        used = 0;
+        peakUsed = 0;
+    }
+
+    size_t getCapacity() const noexcept { return capacity; }
+
+    /** High-water mark since prepare() */
+    size_t getPeakUsage() const noexcept { return peakUsed; }
+
+    /** Aligned, uninitialised slice of numFloats floats, valid until the enclosing Scope closes */
+    float* allocate (size_t numFloats) noexcept
+    {
+        return static_cast<float*> (take (getSliceBytes (numFloats)));
+    }
+
+    /** Uninitialised numChannels x numSamples block, valid until the enclosing Scope closes */
+    juce::dsp::AudioBlock<float> allocateBlock (size_t numChannels, size_t numSamples) noexcept
+    {
+        auto** channels = static_cast<float**> (take (alignUp (numChannels * sizeof (float*))));
+
+        for (size_t ch = 0; ch < numChannels; ++ch)
+            channels[ch] = allocate (numSamples);
+
+        return { channels, numChannels, numSamples };
+    }
+
+    /** Releases everything allocated after its construction when it goes out of scope */
+    class Scope
+    {
+    public:
+        explicit Scope (ScratchArena& arenaToUse) noexcept : arena (arenaToUse), mark (arenaToUse.used) {}
+        ~Scope() { arena.used = mark; }
+
+    private:
+        ScratchArena& arena;
+        const size_t mark;
+
+        JUCE_DECLARE_NON_COPYABLE (Scope)
+    };
+
+    /** Marks the calling thread as running the audio callback while it exists (debug builds) */
+    class AudioThreadScope
+    {
+    public:
+      #if JUCE_DEBUG
+        AudioThreadScope() noexcept : wasAudioThread (isAudioThread()) { isAudioThread() = true; }
+        ~AudioThreadScope() { isAudioThread() = wasAudioThread; }
+      #else
+        AudioThreadScope() noexcept {}
+      #endif
+
+    private:
+      #if JUCE_DEBUG
+        const bool wasAudioThread;
+      #endif
+
+        JUCE_DECLARE_NON_COPYABLE (AudioThreadScope)
+    };
+
+    /** Called wherever a buffer is (re)sized: asserts if that happens inside the audio callback */
+    static void assertNotOnAudioThread() noexcept
+    {
+      #if JUCE_DEBUG
+        jassert (! isAudioThread());
+      #endif
+    }
+
+private:
+    static constexpr size_t alignUp (size_t numBytes) noexcept
+    {
+        return (numBytes + kAlignment - 1) & ~(kAlignment - 1);
+    }
+
+    void* take (size_t numBytes) noexcept
+    {
+        // Sized in prepare() for the worst case: running out means a stage's
+        // requirement is missing from its getScratchBytes()
+        jassert (used + numBytes <= capacity);
+
+        auto* slice = base + used;
+        used += numBytes;
+        peakUsed = juce::jmax (peakUsed, used);
+        return slice;
+    }
+
+  #if JUCE_DEBUG
+    static bool& isAudioThread() noexcept
+    {
+        thread_local bool audioThread = false;
+        return audioThread;
+    }
+  #endif
+
+    juce::HeapBlock<char> storage;
+    char* base = nullptr;
+    size_t capacity = 0;
+    size_t used = 0;
+    size_t peakUsed = 0;
+};
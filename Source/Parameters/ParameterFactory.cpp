@@ -46,6 +46,29 @@ void ParameterFactory::addFlavorParameters (std::vector<std::unique_ptr<juce::Ra
         juce::StringArray { "Cola", "Cherry", "Grape", "Lemon-Lime", "Orange Cream" },
         0  // Default to Cola
     ));
+
+    // Blend: morph continuously between the flavor and a second flavor slot
+    params.push_back (std::make_unique<juce::AudioParameterBool> (
+        blend,
+        "Blend",
+        false
+    ));
+
+    params.push_back (std::make_unique<juce::AudioParameterChoice> (
+        blendFlavor,
+        "Blend Flavor",
+        juce::StringArray { "Cola", "Cherry", "Grape", "Lemon-Lime", "Orange Cream" },
+        1  // Default to Cherry
+    ));
+
+    // Blend Morph: 0% = Flavor only, 100% = Blend Flavor only
+    params.push_back (std::make_unique<juce::AudioParameterFloat> (
+        blendMorph,
+        "Blend Morph",
+        juce::NormalisableRange<float> (0.0f, 100.0f, 0.1f),
+        50.0f,
+        juce::AudioParameterFloatAttributes().withLabel ("%")
+    ));
 }
 
 void ParameterFactory::addGlobalParameters (std::vector<std::unique_ptr<juce::RangedAudioParameter>>& params)
@@ -68,10 +91,38 @@ void ParameterFactory::addGlobalParameters (std::vector<std::unique_ptr<juce::Ra
         false
     ));
 
-    // HQ Mode (4x oversampling on/off)
-    params.push_back (std::make_unique<juce::AudioParameterBool> (
+    // Quality: Standard (1x), HQ (oversampled saturation), ADAA (1x anti-aliased, half-sample latency),
+    //          HQ Chain (entire flavor oversampled 4x)
+    // A new ID: the former HQ on/off switch (Global::legacyHQMode) is mapped
+    // onto it when an old session is loaded
+    params.push_back (std::make_unique<juce::AudioParameterChoice> (
         qualityMode,
-        "HQ Mode",
-        true  // Default to ON (high quality)
+        "Quality",
+        juce::StringArray { "Standard", "HQ", "ADAA", "HQ Chain" },
+        static_cast<int> (QualityMode::HighQuality)  // Default to HQ
+    ));
+
+    // HQ oversampling factor (Standard mode is the 1x setting)
+    params.push_back (std::make_unique<juce::AudioParameterChoice> (
+        oversampling,
+        "Oversampling",
+        juce::StringArray { "2x", "4x", "8x", "16x" },
+        1  // Default to 4x
+    ));
+
+    // HQ half-band filters: minimum-phase IIR (low latency) or linear-phase FIR
+    params.push_back (std::make_unique<juce::AudioParameterChoice> (
+        oversamplingFilter,
+        "Oversampling Filter",
+        juce::StringArray { "Min Phase (IIR)", "Linear Phase (FIR)" },
+        0  // Default to IIR
+    ));
+
+    // Constant latency: report the worst case of every quality setting and pad
+    // the faster ones, so switching quality never changes the host's PDC
+    params.push_back (std::make_unique<juce::AudioParameterBool> (
+        constantLatency,
+        "Constant Latency",
+        false
     ));
 }
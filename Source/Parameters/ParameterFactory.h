@@ -4,7 +4,7 @@
 
 /**
  * Factory class for creating Soda Filter APVTS parameter layout
- * Defines 5 parameters: fizz, carbonated, flavor type, output gain, bypass
+ * Defines the parameters listed in ParameterIDs.h
  */
 class ParameterFactory
 {
@@ -4,7 +4,12 @@
 
 /**
  * Carbonator v2.0 Parameter IDs
- * 5 parameters: fizz, carbonated, flavor type, output gain, bypass
+ * 12 parameters: fizz, carbonated, flavor type, blend, blend flavor,
+ * blend morph, output gain, bypass, quality mode, oversampling factor,
+ * oversampling filter, constant latency
+ * Parameters added after v2.0's first release carry version hint 2. An ID
+ * is never reused for a parameter of another type: hosts recall automation
+ * by ID as a normalised value.
  */
 namespace ParameterIDs
 {
@@ -19,6 +24,9 @@ namespace ParameterIDs
     namespace Flavor
     {
         inline const juce::ParameterID type          { "flavorType",     1 };  // 0=Cola, 1=Cherry, 2=Grape, 3=LemonLime, 4=OrangeCream
+        inline const juce::ParameterID blend         { "blend",          2 };  // Bool: morph between flavor and blend flavor
+        inline const juce::ParameterID blendFlavor   { "blendFlavor",    2 };  // Second flavor slot, same indices as flavorType
+        inline const juce::ParameterID blendMorph    { "blendMorph",     2 };  // 0-100%: 0 = flavor, 100 = blend flavor
     }
 
     // Global Parameters
@@ -26,7 +34,14 @@ namespace ParameterIDs
     {
         inline const juce::ParameterID outputGain    { "outputGain",    1 };  // -12 to +12 dB
         inline const juce::ParameterID bypass        { "bypass",        1 };  // Bool: Global bypass
-        inline const juce::ParameterID qualityMode   { "qualityMode",   1 };  // Bool: HQ mode (4x oversampling)
+        inline const juce::ParameterID qualityMode   { "quality",       2 };  // 0=Standard, 1=HQ (oversampled), 2=ADAA, 3=HQ Chain
+        inline const juce::ParameterID oversampling  { "oversampling",  2 };  // HQ factor: 0=2x, 1=4x, 2=8x, 3=16x
+        inline const juce::ParameterID oversamplingFilter { "oversamplingFilter", 2 };  // 0=Min Phase (IIR), 1=Linear Phase (FIR)
+        inline const juce::ParameterID constantLatency { "constantLatency", 2 };  // Bool: always report the worst-case latency
+
+        // Former HQ on/off switch (Bool) — no longer a parameter; saved
+        // sessions are mapped onto qualityMode in setStateInformation()
+        inline const juce::ParameterID legacyHQMode  { "qualityMode",   1 };
     }
 }
 
@@ -41,3 +56,15 @@ enum class FlavorType
     LemonLime,       // Crisp Exciter
     OrangeCream      // Stereo Width + Warmth
 };
+
+/**
+ * Saturation anti-aliasing quality.
+ * Standard/HQ keep the indices of the former HQ off/on switch.
+ */
+enum class QualityMode
+{
+    Standard = 0,    // 1x, no anti-aliasing — lowest CPU
+    HighQuality,     // 2x-16x oversampled saturation (see Global::oversampling)
+    ADAA,            // 1x antiderivative anti-aliasing — half-sample latency, low CPU
+    OversampledChain // Whole flavor (filters, compressors too) at 4x — highest CPU
+};
@@ -3,6 +3,9 @@
 #include "Parameters/ParameterFactory.h"
 #include <cmath>
 
+// State property (not a parameter) holding the instance's noise seed, as hex
+static const juce::Identifier noiseSeedProperty { "noiseSeed" };
+
 //==============================================================================
 SodaFilterAudioProcessor::SodaFilterAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -20,6 +23,12 @@ SodaFilterAudioProcessor::SodaFilterAudioProcessor()
     // Create effects chain
     effectsChain = std::make_unique<EffectsChain>(apvts);
 
+    // Every instance gets its own noise (Grape's crackle and rumble), kept in
+    // the state so a reloaded session renders the same noise again
+    const auto noiseSeed = juce::Random::getSystemRandom().nextInt64();
+    apvts.state.setProperty (noiseSeedProperty, juce::String::toHexString (noiseSeed), nullptr);
+    applyNoiseSeed();
+
 #ifndef CARBONATOR_DEMO
     // Licensing — must be after effectsChain creation
     licenseManager = std::make_unique<LicenseManager>();
@@ -66,8 +75,8 @@ bool SodaFilterAudioProcessor::isMidiEffect() const
 
 double SodaFilterAudioProcessor::getTailLengthSeconds() const
 {
-    // Tail for modulated delays and chorus effects
-    return 0.5;
+    // Per flavor: filter ring-down and delays (infinite for Grape's vinyl layer)
+    return effectsChain->getTailLengthSeconds();
 }
 
 int SodaFilterAudioProcessor::getNumPrograms()
@@ -105,6 +114,9 @@ void SodaFilterAudioProcessor::prepareToPlay (double sampleRate, int samplesPerB
     spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock);
     spec.numChannels = static_cast<juce::uint32>(getTotalNumOutputChannels());
 
+    // Hosts flag an offline bounce before re-preparing: the render profile is
+    // latched here (and its latency known) before the first rendered block
+    effectsChain->setNonRealtime (isNonRealtime());
     effectsChain->prepare (spec);
 
     // Report oversampling latency to host
@@ -163,12 +175,42 @@ void SodaFilterAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
     juce::dsp::ProcessContextReplacing<float> context (block);
     effectsChain->process (context);
 
-    // Update latency if quality mode changed
+    // Idle instance: flag the buffer as cleared so the silence propagates
+    if (effectsChain->isOutputSilent())
+        buffer.clear();
+
+    // Update latency if quality mode changed (never changes while Constant
+    // Latency is on, or during an offline render)
     int newLatency = static_cast<int> (std::ceil (effectsChain->getLatencyInSamples()));
     if (newLatency != getLatencySamples())
         setLatencySamples (newLatency);
 }
 
+void SodaFilterAudioProcessor::processBlockBypassed (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused (midiMessages);
+
+    juce::ScopedNoDenormals noDenormals;
+
+    for (auto i = getTotalNumInputChannels(); i < getTotalNumOutputChannels(); ++i)
+        buffer.clear (i, 0, buffer.getNumSamples());
+
+    // Host-side bypass: the same delay-matched dry path and crossfade as the
+    // Bypass parameter, so the reported latency still holds
+    juce::dsp::AudioBlock<float> block (buffer);
+    juce::dsp::ProcessContextReplacing<float> context (block);
+    context.isBypassed = true;
+    effectsChain->process (context);
+
+    if (effectsChain->isOutputSilent())
+        buffer.clear();
+}
+
+juce::AudioProcessorParameter* SodaFilterAudioProcessor::getBypassParameter() const
+{
+    return apvts.getParameter (ParameterIDs::Global::bypass.getParamID());
+}
+
 //==============================================================================
 bool SodaFilterAudioProcessor::hasEditor() const
 {
@@ -195,8 +237,41 @@ void SodaFilterAudioProcessor::setStateInformation (const void* data, int sizeIn
     std::unique_ptr<juce::XmlElement> xmlState (getXmlFromBinary (data, sizeInBytes));
 
     if (xmlState.get() != nullptr)
+    {
         if (xmlState->hasTagName (apvts.state.getType()))
+        {
+            migrateLegacyState (*xmlState);
             apvts.replaceState (juce::ValueTree::fromXml (*xmlState));
+            applyNoiseSeed();
+        }
+    }
+}
+
+void SodaFilterAudioProcessor::migrateLegacyState (juce::XmlElement& state)
+{
+    using namespace ParameterIDs;
+
+    // Saved before seeds were per instance: the seed every instance had then
+    if (! state.hasAttribute (noiseSeedProperty.toString()))
+        state.setAttribute (noiseSeedProperty, juce::String::toHexString (static_cast<juce::int64> (FlavorEngine::kDefaultNoiseSeed)));
+
+    // HQ on/off switch -> Quality choice: on = HQ, off = Standard
+    if (state.getChildByAttribute ("id", Global::qualityMode.getParamID()) != nullptr)
+        return;
+
+    if (auto* legacy = state.getChildByAttribute ("id", Global::legacyHQMode.getParamID()))
+    {
+        const auto mode = legacy->getDoubleAttribute ("value") >= 0.5 ? QualityMode::HighQuality
+                                                                       : QualityMode::Standard;
+        legacy->setAttribute ("id", Global::qualityMode.getParamID());
+        legacy->setAttribute ("value", static_cast<int> (mode));
+    }
+}
+
+void SodaFilterAudioProcessor::applyNoiseSeed()
+{
+    const auto seed = apvts.state.getProperty (noiseSeedProperty).toString().getHexValue64();
+    effectsChain->setNoiseSeed (static_cast<std::uint64_t> (seed));
 }
 
 //==============================================================================
@@ -31,6 +31,11 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlockBypassed (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+
+    /** The Bypass parameter, so hosts drive the plugin's own latency-matched,
+     *  crossfaded bypass instead of cutting to the unprocessed input */
+    juce::AudioProcessorParameter* getBypassParameter() const override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -62,6 +67,9 @@ public:
     // Undo/Redo functionality
     juce::UndoManager& getUndoManager() { return undoManager; }
 
+    // Heap held by this instance, per flavor and per buffer (message thread)
+    MemoryReport getMemoryReport() const { return effectsChain->getMemoryReport(); }
+
 #ifndef CARBONATOR_DEMO
     bool isActivated() const { return licenseManager->isActivated(); }
     LicenseManager& getLicenseManager() { return *licenseManager; }
@@ -74,6 +82,12 @@ private:
     juce::AudioProcessorValueTreeState apvts;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+    /** Maps parameters saved by older versions onto their replacements */
+    static void migrateLegacyState (juce::XmlElement& state);
+
+    /** Pushes the state's noise seed to the effects chain */
+    void applyNoiseSeed();
+
     // DSP processing chain
     std::unique_ptr<EffectsChain> effectsChain;
 